@@ -25,94 +25,527 @@ SOFTWARE.
 #include <cstring>
 #include <cmath>
 #include <cstdint>
+#include <cerrno>
+#include <cfloat>
+#include <cinttypes>
+#include <cstdarg>
+#include <charconv>
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#if defined( _WIN32 )
+#	define WIN32_LEAN_AND_MEAN
+#	define NOMINMAX
+#	include <windows.h>
+#else
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#	define BIN2OBJ_SSE2
+#	include <emmintrin.h>
+#	if defined( __SSSE3__ )
+#		include <tmmintrin.h>
+#	endif
+#	if defined( __SSE4_1__ )
+#		include <smmintrin.h>
+#	endif
+#	if defined( __AVX2__ ) || defined( __F16C__ )
+#		include <immintrin.h>
+#	endif
+#endif
+
 struct Vertex {
 	float x{ 0 }, y{ 0 }, z{ 0 };
 
 	void operator*=( float v ) { x *= v; y *= v; z *= v; }
 };
 
+struct TexCoord {
+	float u{ 0 }, v{ 0 };
+};
+
 struct Face {
 	unsigned int x{ 0 }, y{ 0 }, z{ 0 }, w{ 0 };
 };
 
-static struct Environment {
-	const char* filePath{ nullptr };
-	const char* outPath{ "dump.obj" };
-	unsigned long startOffset{ 0 };
-	unsigned long stride{ 0 };
-	unsigned long endOffset{ 0 };
+/**
+ * Vertices stored as separate X, Y and Z arrays, for the stages that work on
+ * one component across several vertices at a time. Each array starts on a
+ * 64 byte boundary and is padded out to a multiple of 16 floats.
+ */
+struct VertexArrays {
+	float* x{ nullptr };
+	float* y{ nullptr };
+	float* z{ nullptr };
+	size_t count{ 0 };
+
+	// Doesn't keep what was there before.
+	void Resize(size_t newCount) {
+		size_t padded = (newCount + 15) & ~(size_t)15;
+		storage.resize(padded * 3 + 16);
+		x = (float*)(((uintptr_t)storage.data() + 63) & ~(uintptr_t)63);
+		y = x + padded;
+		z = y + padded;
+		count = newCount;
+	}
+
+private:
+	std::vector<float> storage;
+};
+
+/**
+ * Everything describing a single extraction, along with the mesh it produces.
+ */
+struct Job {
+	std::string filePath;
+	std::string outPath{ "dump.obj" };
+	enum class OutputFormat {
+		AUTO = -1,
+		OBJ,
+		PLY,
+		GLB,
+	} outputFormat{ OutputFormat::AUTO };
+	uint64_t startOffset{ 0 };
+	uint64_t stride{ 0 };
+	uint64_t endOffset{ 0 };
 
 	float scale{ 1.0f };
     enum class VertexType {
         F32,
         I16,
+        F16,
+        UNORM8,
+        SNORM8,
+        UNORM16,
+        SNORM16,
+        FX32,   // 16.16 fixed-point
+        UNORM10_10_10_2,
+        SNORM10_10_10_2,
+        F11_11_10,
     } vertexType{ VertexType::F32 };
+	int vertexFractionalBits{ -1 };
+	bool vertexBigEndian{ false };
+
+	/**
+	 * Where an attribute sits within each vertex, as set up by -vlay.
+	 */
+	struct Attribute {
+		VertexType type{ VertexType::F32 };
+		size_t offset{ 0 };
+		bool present{ false };
+	};
+	Attribute vertexNormal, vertexTexCoord;
+	size_t vertexPositionOffset{ 0 };
+	size_t vertexLayoutSize{ 0 }; // 0 unless there's a layout
 
-	unsigned long faceStartOffset{ 0 };
-	unsigned long faceEndOffset{ 0 };
-	unsigned long faceStride{ 0 };
+	uint64_t faceStartOffset{ 0 };
+	uint64_t faceEndOffset{ 0 };
+	uint64_t faceStride{ 0 };
     enum class FaceType {
         I16,
         I32,
     } faceType{ FaceType::I32 };
     bool faceQuad{ false };
+    enum class FaceTopology {
+        LIST,
+        STRIP,
+        FAN,
+    } faceTopology{ FaceTopology::LIST };
+	bool faceRestart{ false };
+	bool faceAdcFlags{ false };
+	bool faceBigEndian{ false };
 	std::vector<Face> meshFaces;
 
-	bool verbose{ false };
+	bool soaVertices{ false };
+
+	bool flushNonFinite{ false };
+
+	bool dropOutOfBounds{ false };
+
+	bool weld{ false };
+	float weldTolerance{ 0.0f };
+
+	int precision{ -1 };
+
+	size_t streamWindow{ 0 };
+
+	bool scanVertices{ false };
+	size_t scanMinCount{ 32 };
+	float scanBound{ 100000.0f };
+	bool scanFaces{ false };
+	size_t scanVertexCount{ 0 };
 
 	std::vector<Vertex> meshVertices;
+	std::vector<Vertex> meshNormals;
+	std::vector<TexCoord> meshTexCoords;
+};
+
+static struct Environment {
+	unsigned int numThreads{ 0 };
+
+	bool verbose{ false };
+
+	std::vector<Job> jobs;
 } env;
 
+/**
+ * Set while one of several jobs is running on this thread, and put at the
+ * start of each line it prints, so that the output of jobs running alongside
+ * each other can still be told apart.
+ */
+static thread_local const char* logPrefix = nullptr;
+static thread_local bool logLineStart = true;
+
+#if defined( __GNUC__ )
+__attribute__((format(printf, 1, 2)))
+#endif
+static void LogPrintf(const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	if (logPrefix == nullptr) {
+		vprintf(format, args);
+		va_end(args);
+		return;
+	}
+
+	// Format the whole message up front so it goes out in one piece, rather
+	// than being broken up by whatever the other jobs are printing.
+	va_list argsCopy;
+	va_copy(argsCopy, args);
+	int length = vsnprintf(nullptr, 0, format, argsCopy);
+	va_end(argsCopy);
+	std::vector<char> message(length > 0 ? (size_t)length + 1 : 1, '\0');
+	vsnprintf(message.data(), message.size(), format, args);
+	va_end(args);
+
+	std::string out;
+	for (size_t i = 0; message[i] != '\0'; ++i) {
+		if (logLineStart) {
+			out += logPrefix;
+		}
+		out += message[i];
+		logLineStart = message[i] == '\n';
+	}
+	fputs(out.c_str(), stdout);
+}
+
 #define AbortApp( ... ) printf( __VA_ARGS__ ); exit( EXIT_FAILURE )
-#define Print( ... )	printf( __VA_ARGS__ )
-#define VPrint( ... )	if( env.verbose ) { printf( __VA_ARGS__ ); }
-#define Warn( ... )		printf( "WARNING: " __VA_ARGS__ )
-
-static void SetOutPath(const char* argument) { env.outPath = argument; }
-static void SetStartOffset(const char* argument) { env.startOffset = strtoul(argument, nullptr, 10); }
-static void SetEndOffset(const char* argument) { env.endOffset = strtoul(argument, nullptr, 10); }
-static void SetStride(const char* argument) { env.stride = strtoul(argument, nullptr, 10); }
-static void SetVertexScale(const char* argument) { env.scale = strtof(argument, nullptr); }
-static void SetVertexType( const char* argument) { env.vertexType = (Environment::VertexType)strtoul(argument, nullptr, 10); }
-static void SetFaceStartOffset(const char* argument) { env.faceStartOffset = strtoul(argument, nullptr, 10); }
-static void SetFaceEndOffset(const char* argument) { env.faceEndOffset = strtoul(argument, nullptr, 10); }
-static void SetFaceStride(const char* argument) { env.faceStride = strtoul(argument, nullptr, 10); }
-static void SetFaceType(const char* argument) { env.faceType = (Environment::FaceType)strtoul(argument, nullptr, 10); }
-static void SetFaceQuad(const char* argument) { env.faceQuad = true; }
-static void SetVerboseMode(const char* argument) { env.verbose = true; }
+#define Print( ... )	LogPrintf( __VA_ARGS__ )
+#define VPrint( ... )	if( env.verbose ) { LogPrintf( __VA_ARGS__ ); }
+#define Warn( ... )		LogPrintf( "WARNING: " __VA_ARGS__ )
+
+static void SetOutPath(Job* job, const char* argument) { job->outPath = argument; }
+static void SetOutputFormat(Job* job, const char* argument) { job->outputFormat = (Job::OutputFormat)strtol(argument, nullptr, 10); }
+static void SetStartOffset(Job* job, const char* argument) { job->startOffset = strtoull(argument, nullptr, 10); }
+static void SetEndOffset(Job* job, const char* argument) { job->endOffset = strtoull(argument, nullptr, 10); }
+static void SetStride(Job* job, const char* argument) { job->stride = strtoull(argument, nullptr, 10); }
+static void SetVertexScale(Job* job, const char* argument) { job->scale = strtof(argument, nullptr); }
+static void SetVertexType(Job* job, const char* argument) { job->vertexType = (Job::VertexType)strtoul(argument, nullptr, 10); }
+static void SetVertexFractionalBits(Job* job, const char* argument) { job->vertexFractionalBits = (int)strtol(argument, nullptr, 10); }
+static void SetVertexBigEndian(Job* job, const char* argument) { job->vertexBigEndian = true; }
+static void SetVertexLayout(Job* job, const char* argument);
+static void SetFaceStartOffset(Job* job, const char* argument) { job->faceStartOffset = strtoull(argument, nullptr, 10); }
+static void SetFaceEndOffset(Job* job, const char* argument) { job->faceEndOffset = strtoull(argument, nullptr, 10); }
+static void SetFaceStride(Job* job, const char* argument) { job->faceStride = strtoull(argument, nullptr, 10); }
+static void SetFaceType(Job* job, const char* argument) { job->faceType = (Job::FaceType)strtoul(argument, nullptr, 10); }
+static void SetFaceQuad(Job* job, const char* argument) { job->faceQuad = true; }
+static void SetFaceTopology(Job* job, const char* argument) { job->faceTopology = (Job::FaceTopology)strtoul(argument, nullptr, 10); }
+static void SetFaceRestart(Job* job, const char* argument) { job->faceRestart = true; }
+static void SetFaceAdcFlags(Job* job, const char* argument) { job->faceAdcFlags = true; }
+static void SetFaceBigEndian(Job* job, const char* argument) { job->faceBigEndian = true; }
+static void SetFaceBoundsPolicy(Job* job, const char* argument) { job->dropOutOfBounds = strtoul(argument, nullptr, 10) == 1; }
+static void SetWeld(Job* job, const char* argument) { job->weld = true; }
+static void SetWeldTolerance(Job* job, const char* argument) { job->weld = true; job->weldTolerance = strtof(argument, nullptr); }
+static void SetPrecision(Job* job, const char* argument) { job->precision = (int)strtol(argument, nullptr, 10); }
+static void SetStreamWindow(Job* job, const char* argument) { job->streamWindow = strtoul(argument, nullptr, 10); }
+static void SetScanVertices(Job* job, const char* argument) { job->scanVertices = true; }
+static void SetScanMinCount(Job* job, const char* argument) { job->scanMinCount = strtoul(argument, nullptr, 10); }
+static void SetScanBound(Job* job, const char* argument) { job->scanBound = strtof(argument, nullptr); }
+static void SetScanFaces(Job* job, const char* argument) { job->scanFaces = true; }
+static void SetScanVertexCount(Job* job, const char* argument) { job->scanVertexCount = strtoul(argument, nullptr, 10); }
+static void SetNumThreads(Job* job, const char* argument) { env.numThreads = (unsigned int)strtoul(argument, nullptr, 10); }
+static void SetFlushNonFinite(Job* job, const char* argument) { job->flushNonFinite = true; }
+static void SetSoaVertices(Job* job, const char* argument) { job->soaVertices = true; }
+static void SetVerboseMode(Job* job, const char* argument) { env.verbose = true; }
+
+static void LoadManifest(Job* job, const char* argument);
+
+struct LaunchArgument {
+	const char* str;
+	void(*Callback)(Job* job, const char* argument);
+	const char* desc;
+};
+// All possible arguments go in this table.
+static const LaunchArgument launchArguments[] = {
+	{ "-soff", SetStartOffset, "Set the start offset to begin reading from." },
+	{ "-eoff", SetEndOffset, "Set the end offset to stop reading, otherwise reads to EOF." },
+	{ "-stri", SetStride, "Number of bytes to proceed after reading XYZ." },
+	{ "-outp", SetOutPath, "Set the path for the output file." },
+	{ "-ofmt", SetOutputFormat, "Sets the output format, otherwise picked from the output extension.\n"
+	                            "0 = obj (default), 1 = binary ply, 2 = glb" },
+	{ "-vtxs", SetVertexScale, "Scales the vertices by the defined amount." },
+	{ "-vfin", SetFlushNonFinite, "Also zero any infinite or denormal vertex components, not just NaNs." },
+	{ "-vsoa", SetSoaVertices, "Decodes and sanitises the vertices as separate X, Y and Z arrays, only\n"
+	                           "interleaving them for output." },
+	{ "-vtyp", SetVertexType, "Sets how the vertex bytes are stored.\n"
+	                          "0 = float32 (default), 1 = int16, 2 = float16, 3 = unorm8, 4 = snorm8,\n"
+	                          "5 = unorm16, 6 = snorm16, 7 = 16.16 fixed-point, 8 = unorm 10:10:10:2,\n"
+	                          "9 = snorm 10:10:10:2, 10 = float 11:11:10" },
+	{ "-vfrc", SetVertexFractionalBits, "Number of fractional bits in int16 and fixed-point vertices, otherwise 0\n"
+	                                    "for int16 and 16 for 16.16." },
+	{ "-vbig", SetVertexBigEndian, "Indicates that the vertices are stored big-endian." },
+	{ "-vlay", SetVertexLayout, "Describes each vertex as a list of attributes, such as \"pos:f32x3 nrm:i16x3n uv:f16x2 pad:4\",\n"
+	                            "in place of -vtyp. Normals (nrm) and texture coordinates (uv) are written to obj.\n"
+	                            "Types are f32, f16, i16, i16n, u16n, i8n, u8n and fx32, or i10n, u10n and f11\n"
+	                            "for packed x3, and pad skips the given number of bytes." },
+	{ "-fsof", SetFaceStartOffset, "Sets the start offset to start loading face indices from." },
+	{ "-feof", SetFaceEndOffset, "Sets the end offset to finish loading face indices from." },
+	{ "-fstr", SetFaceStride, "Number of bytes to proceed after reading in face indices." },
+	{ "-ftyp", SetFaceType, "Sets how the face bytes are stored.\n"
+	                        "0 = int16, 1 = int32" },
+	{ "-fquad", SetFaceQuad, "Indicates that the faces are made up of four elements, a quad." },
+	{ "-ftop", SetFaceTopology, "Sets how the face indices are arranged, strips and fans being turned into triangles.\n"
+	                            "0 = list (default), 1 = strip, 2 = fan" },
+	{ "-frst", SetFaceRestart, "Indicates that an index of 0xFFFF, or 0xFFFFFFFF for int32, restarts the strip or fan." },
+	{ "-fadc", SetFaceAdcFlags, "Indicates that the top bit of each strip or fan index is a PS2-style ADC flag,\n"
+	                            "skipping the triangle that index completes." },
+	{ "-fbig", SetFaceBigEndian, "Indicates that the face indices are stored big-endian." },
+	{ "-fbnd", SetFaceBoundsPolicy, "Sets what happens to faces indexing past the last vertex.\n"
+	                                "0 = set those indices to 0 (default), 1 = drop the face" },
+	{ "-weld", SetWeld, "Merges vertices that share the exact same position, remapping the faces." },
+	{ "-wldt", SetWeldTolerance, "Merges vertices falling within the same grid cell of the given size." },
+	{ "-prec", SetPrecision, "Number of decimal places to write vertices with, otherwise the shortest\n"
+	                         "representation that reads back exactly is used." },
+	{ "-strm", SetStreamWindow, "Streams the mesh through the given number of vertices or faces at a time,\n"
+	                            "rather than loading it all in. Only supported for obj output, without -weld." },
+	{ "-vscn", SetScanVertices, "Rather than extracting, scans between the start and end offsets for\n"
+	                            "anything that looks like an array of vertices and lists the best matches." },
+	{ "-iscn", SetScanFaces, "Rather than extracting, scans between the start and end offsets for anything\n"
+	                         "that looks like a list of face indices and lists the best matches." },
+	{ "-scvc", SetScanVertexCount, "Number of vertices scanned faces may index. If scanning for vertices too,\n"
+	                               "faces within the best vertex array are only preferred otherwise." },
+	{ "-scnm", SetScanMinCount, "Minimum number of vertices or faces a scanned run needs to be reported, 32 by default." },
+	{ "-scnb", SetScanBound, "Largest vertex coordinate the scanner will accept, 100000 by default." },
+	{ "-mani", LoadManifest, "Loads jobs from the given manifest file. Each line is a job, written the same\n"
+	                         "way as on the command line, and # starts a comment." },
+	{ "-thrd", SetNumThreads, "Number of threads to use, otherwise one per core. Applies to all jobs." },
+	{ "-verb", SetVerboseMode, "Enables more verbose output. Applies to all jobs." },
+	{ nullptr }
+};
+
+/**
+ * Types an attribute can have in a -vlay layout. Packed types have no
+ * component size, as all three components share 4 bytes.
+ */
+static const struct {
+	const char* name;
+	Job::VertexType type;
+	size_t componentSize;
+} layoutTypes[] = {
+	{ "f32", Job::VertexType::F32, sizeof(float) },
+	{ "f16", Job::VertexType::F16, sizeof(uint16_t) },
+	{ "i16", Job::VertexType::I16, sizeof(int16_t) },
+	{ "i16n", Job::VertexType::SNORM16, sizeof(int16_t) },
+	{ "u16n", Job::VertexType::UNORM16, sizeof(uint16_t) },
+	{ "i8n", Job::VertexType::SNORM8, sizeof(int8_t) },
+	{ "u8n", Job::VertexType::UNORM8, sizeof(uint8_t) },
+	{ "fx32", Job::VertexType::FX32, sizeof(int32_t) },
+	{ "i10n", Job::VertexType::SNORM10_10_10_2, 0 },
+	{ "u10n", Job::VertexType::UNORM10_10_10_2, 0 },
+	{ "f11", Job::VertexType::F11_11_10, 0 },
+};
+
+/**
+ * Parses a layout such as "pos:f32x3 nrm:i16x3n uv:f16x2 pad:4" into the job.
+ * Attributes can have more components than are used, such as a W on the
+ * position, which are skipped over.
+ */
+static void SetVertexLayout(Job* job, const char* argument) {
+	if (argument == nullptr) {
+		AbortApp("No vertex layout was provided!\n");
+	}
+
+	bool hasPosition = false;
+	size_t offset = 0;
+	const char* p = argument;
+	for (;;) {
+		while (*p == ' ' || *p == '\t' || *p == ',') {
+			p++;
+		}
+		if (*p == '\0') {
+			break;
+		}
+		const char* end = p + strcspn(p, " \t,");
+		std::string token(p, end);
+		p = end;
+
+		size_t colon = token.find(':');
+		if (colon == std::string::npos) {
+			AbortApp("Vertex layout attribute \"%s\" is missing its type!\n", token.c_str());
+		}
+		std::string name = token.substr(0, colon);
+		std::string spec = token.substr(colon + 1);
+		if (name == "pad") {
+			char* padEnd;
+			unsigned long numBytes = strtoul(spec.c_str(), &padEnd, 10);
+			if (spec.empty() || *padEnd != '\0') {
+				AbortApp("Invalid padding in vertex layout attribute \"%s\"!\n", token.c_str());
+			}
+			offset += numBytes;
+			continue;
+		}
+
+		// Split "i16x3n" into its type, "i16n", and number of components, 3.
+		bool normalised = !spec.empty() && spec.back() == 'n';
+		if (normalised) {
+			spec.pop_back();
+		}
+		size_t x = spec.find_last_of('x');
+		unsigned long numComponents = 0;
+		if (x != std::string::npos && x + 1 < spec.size()) {
+			char* countEnd;
+			numComponents = strtoul(spec.c_str() + x + 1, &countEnd, 10);
+			if (*countEnd != '\0') {
+				numComponents = 0;
+			}
+		}
+		if (numComponents == 0) {
+			AbortApp("Vertex layout attribute \"%s\" is missing its number of components!\n", token.c_str());
+		}
+		std::string typeName = spec.substr(0, x) + (normalised ? "n" : "");
+
+		auto* type = std::find_if(std::begin(layoutTypes), std::end(layoutTypes), [&](const auto& t) { return typeName == t.name; });
+		if (type == std::end(layoutTypes)) {
+			AbortApp("Unknown type in vertex layout attribute \"%s\"!\n", token.c_str());
+		}
+
+		Job::Attribute attribute;
+		unsigned int numUsed;
+		if (name == "pos") {
+			numUsed = 3;
+			hasPosition = true;
+			job->vertexType = type->type;
+			job->vertexPositionOffset = offset;
+		} else if (name == "nrm") {
+			numUsed = 3;
+			job->vertexNormal = { type->type, offset, true };
+		} else if (name == "uv") {
+			numUsed = 2;
+			job->vertexTexCoord = { type->type, offset, true };
+		} else {
+			AbortApp("Unknown vertex layout attribute \"%s\", expected pos, nrm, uv or pad!\n", token.c_str());
+		}
+		if (type->componentSize == 0 ? numComponents != numUsed || numUsed != 3 : numComponents < numUsed) {
+			AbortApp("Vertex layout attribute \"%s\" has the wrong number of components!\n", token.c_str());
+		}
+		offset += type->componentSize == 0 ? sizeof(uint32_t) : type->componentSize * numComponents;
+	}
+
+	if (!hasPosition) {
+		AbortApp("Vertex layout \"%s\" has no position!\n", argument);
+	}
+	job->vertexLayoutSize = offset;
+}
+
+/**
+ * Adds a job made up of the given arguments, where the first is the path to
+ * the file. If there's no path, the arguments are still parsed but no job is
+ * added, which is how options like -mani get through on their own.
+ */
+static void AddJob(int argc, const char* const* argv) {
+	Job job;
+	int first = 0;
+	if (argc > 0 && argv[0][0] != '-') {
+		job.filePath = argv[0];
+		first = 1;
+	}
+
+	for (int i = first; i < argc; ++i) {
+		const LaunchArgument* opt = &launchArguments[0];
+		while (opt->str != nullptr) {
+			if (strcmp(opt->str, argv[i]) == 0) {
+				const char* arg = (i + 1) < argc ? argv[i + 1] : nullptr;
+				opt->Callback(&job, arg);
+				break;
+			}
+			opt++;
+		}
+	}
+
+	if (!job.filePath.empty()) {
+		env.jobs.push_back(std::move(job));
+	}
+}
+
+static void LoadManifest(Job* job, const char* argument) {
+	FILE* file = fopen(argument, "r");
+	if (file == nullptr) {
+		AbortApp("Failed to open manifest \"%s\"!\n", argument);
+	}
+
+	size_t numJobs = env.jobs.size();
+	char line[4096];
+	while (fgets(line, sizeof(line), file) != nullptr) {
+		// Split the line up much like a shell would, so paths can be quoted.
+		std::vector<std::string> tokens;
+		const char* p = line;
+		for (;;) {
+			while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') {
+				p++;
+			}
+			if (*p == '\0' || *p == '#') {
+				break;
+			}
+
+			std::string token;
+			if (*p == '"') {
+				for (p++; *p != '\0' && *p != '"'; p++) {
+					token += *p;
+				}
+				if (*p == '"') {
+					p++;
+				}
+			} else {
+				for (; *p != '\0' && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n'; p++) {
+					token += *p;
+				}
+			}
+			tokens.push_back(std::move(token));
+		}
+
+		if (tokens.empty()) {
+			continue;
+		}
+
+		std::vector<const char*> arguments;
+		for (const auto& token : tokens) {
+			arguments.push_back(token.c_str());
+		}
+		AddJob((int)arguments.size(), arguments.data());
+	}
+	fclose(file);
+
+	Print("Loaded %zu jobs from \"%s\"\n", env.jobs.size() - numJobs, argument);
+}
 
 /**
  * Parse all arguments on the command line based on the provided table.
  */
 static void ParseCommandLine(int argc, char** argv) {
-	struct LaunchArgument {
-		const char* str;
-		void(*Callback)(const char* argument);
-		const char* desc;
-	};
-	// All possible arguments go in this table.
-	static LaunchArgument launchArguments[] = {
-		{ "-soff", SetStartOffset, "Set the start offset to begin reading from." },
-		{ "-eoff", SetEndOffset, "Set the end offset to stop reading, otherwise reads to EOF." },
-		{ "-stri", SetStride, "Number of bytes to proceed after reading XYZ." },
-		{ "-outp", SetOutPath, "Set the path for the output file." },
-		{ "-vtxs", SetVertexScale, "Scales the vertices by the defined amount." },
-        { "-vtyp", SetVertexType, "Sets how the vertex bytes are stored.\n"
-                                  "0 = float32 (default), 1 = int16" },
-		{ "-fsof", SetFaceStartOffset, "Sets the start offset to start loading face indices from." },
-		{ "-feof", SetFaceEndOffset, "Sets the end offset to finish loading face indices from." },
-		{ "-fstr", SetFaceStride, "Number of bytes to proceed after reading in face indices." },
-        { "-ftyp", SetFaceType, "Sets how the face bytes are stored.\n"
-                                "0 = int16, 1 = int32" },
-        { "-fquad", SetFaceQuad, "Indicates that the faces are made up of four elements, a quad." },
-		{ "-verb", SetVerboseMode, "Enables more verbose output." },
-		{ nullptr }
-	};
-
 	// If we don't have any arguments, print them out.
 	if (argc <= 1) {
 		Print("No arguments provided. Possible arguments are provided below.\n");
@@ -122,271 +555,3219 @@ static void ParseCommandLine(int argc, char** argv) {
 			Print("   %s\t\t%s\n", opt->str, opt->desc);
 			opt++;
 		}
+		Print("Several jobs can be run at once by separating them with \"--\", each beginning with its own file path.\n");
 		Print("For example,\n\tbin2obj ..\\path\\myfile.whatever -soff 128\n");
 		exit(EXIT_SUCCESS);
 		return;
 	}
 
-	const LaunchArgument* opt = &launchArguments[0];
-	while (opt->str != nullptr) {
-		for (int i = 0; i < argc; ++i) {
-			if (strcmp(opt->str, argv[i]) != 0) {
-				continue;
-			}
+	// Each job starts with the path to the file, and runs up until the next "--".
+	for (int i = 1; i < argc; ++i) {
+		int end = i;
+		while (end < argc && strcmp(argv[end], "--") != 0) {
+			end++;
+		}
+
+		AddJob(end - i, argv + i);
+		i = end;
+	}
+
+	if (env.jobs.empty()) {
+		AbortApp("No jobs were provided!\n");
+	}
+}
+
+/**
+ * Input file we're extracting from. Where possible the file is mapped into
+ * memory, otherwise we fall back to reading the requested range via stdio.
+ */
+struct InputFile {
+	const char* path{ nullptr };
+	uint64_t size{ 0 };
+	bool mappable{ false };
+#if defined( _WIN32 )
+	HANDLE handle{ INVALID_HANDLE_VALUE };
+	HANDLE mapping{ nullptr };
+#else
+	int fd{ -1 };
+#endif
+};
+
+/**
+ * A contiguous span of bytes from the input file.
+ */
+struct InputView {
+	const uint8_t* data{ nullptr };
+	size_t size{ 0 };
+
+	void* mapBase{ nullptr };
+	size_t mapSize{ 0 };
+	std::vector<uint8_t> buffer;
+};
+
+static bool OpenInputFile(InputFile* input, const char* path) {
+	input->path = path;
 
-			const char* arg = (i + 1) < argc ? argv[i + 1] : nullptr;
-			opt->Callback(arg);
+#if defined( _WIN32 )
+	input->handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+	                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (input->handle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(input->handle, &fileSize) && fileSize.QuadPart > 0) {
+		input->size = (uint64_t)fileSize.QuadPart;
+		input->mapping = CreateFileMappingA(input->handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		input->mappable = (input->mapping != nullptr);
+	}
+#else
+	input->fd = open(path, O_RDONLY);
+	if (input->fd == -1) {
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(input->fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode)) {
+		input->size = (uint64_t)fileStat.st_size;
+		input->mappable = input->size > 0;
+	} else {
+		// Block devices and the like report no size, but can still be seeked to the end.
+		off_t end = lseek(input->fd, 0, SEEK_END);
+		input->size = end > 0 ? (uint64_t)end : 0;
+	}
+#endif
+
+	return true;
+}
+
+static void CloseInputFile(InputFile* input) {
+#if defined( _WIN32 )
+	if (input->mapping != nullptr) {
+		CloseHandle(input->mapping);
+		input->mapping = nullptr;
+	}
+	if (input->handle != INVALID_HANDLE_VALUE) {
+		CloseHandle(input->handle);
+		input->handle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (input->fd != -1) {
+		close(input->fd);
+		input->fd = -1;
+	}
+#endif
+}
+
+/**
+ * Reads from the given offset without touching any shared file position,
+ * so jobs sharing the file don't need to take turns.
+ */
+static size_t ReadInputAt(InputFile* input, uint64_t offset, uint8_t* dst, size_t numBytes) {
+	size_t numRead = 0;
+	while (numRead < numBytes) {
+		uint64_t position = offset + numRead;
+#if defined( _WIN32 )
+		OVERLAPPED overlapped{};
+		overlapped.Offset = (DWORD)position;
+		overlapped.OffsetHigh = (DWORD)(position >> 32);
+		DWORD length = (DWORD)std::min<size_t>(numBytes - numRead, 1u << 30);
+		DWORD numReadNow = 0;
+		if (!ReadFile(input->handle, dst + numRead, length, &numReadNow, &overlapped) || numReadNow == 0) {
+			break;
+		}
+#else
+		ssize_t numReadNow = pread(input->fd, dst + numRead, numBytes - numRead, (off_t)position);
+		if (numReadNow < 0 && errno == EINTR) {
+			continue;
+		} else if (numReadNow <= 0) {
+			break;
 		}
-		opt++;
+#endif
+		numRead += (size_t)numReadNow;
 	}
+
+	return numRead;
 }
 
-static void FileSeek(FILE* file, unsigned long numBytes, bool fromStart) {
-	if (fseek(file, numBytes, fromStart ? SEEK_SET : SEEK_CUR) == 0) {
-		return;
+/**
+ * Provides a view onto the given range of the input file, clamped to the
+ * size of the file. Returns false if nothing could be read.
+ */
+static bool OpenInputView(InputFile* input, uint64_t offset, uint64_t numBytes, InputView* view) {
+	if (offset >= input->size) {
+		return false;
+	}
+	if (numBytes == 0 || numBytes > input->size - offset) {
+		numBytes = input->size - offset;
 	}
 
-	AbortApp("Failed to seek to %lu!\n", numBytes);
+	// 32-bit builds can't hold more than this at once, however it's read.
+	if (numBytes > SIZE_MAX - (1u << 16)) {
+		Warn("Range of %" PRIu64 " bytes is too large to address!\n", numBytes);
+		return false;
+	}
+
+	if (input->mappable) {
+		// Mappings need to begin on an allocation boundary.
+#if defined( _WIN32 )
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		uint64_t granularity = systemInfo.dwAllocationGranularity;
+#else
+		uint64_t granularity = (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+		uint64_t alignedOffset = offset - (offset % granularity);
+		size_t mapSize = (size_t)(numBytes + (offset - alignedOffset));
+
+#if defined( _WIN32 )
+		void* base = MapViewOfFile(input->mapping, FILE_MAP_READ, (DWORD)(alignedOffset >> 32), (DWORD)alignedOffset, mapSize);
+		if (base != nullptr) {
+#else
+		void* base = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, input->fd, (off_t)alignedOffset);
+		if (base != MAP_FAILED) {
+			madvise(base, mapSize, MADV_SEQUENTIAL);
+#endif
+			view->mapBase = base;
+			view->mapSize = mapSize;
+			view->data = (const uint8_t*)base + (offset - alignedOffset);
+			view->size = (size_t)numBytes;
+			return true;
+		}
+
+		Warn("Failed to map \"%s\", falling back to buffered reads!\n", input->path);
+	}
+
+	view->buffer.resize((size_t)numBytes);
+	view->buffer.resize(ReadInputAt(input, offset, view->buffer.data(), view->buffer.size()));
+	view->data = view->buffer.data();
+	view->size = view->buffer.size();
+	return view->size > 0;
 }
 
-#define CloseFile(FILE) if( (FILE) != nullptr ) fclose( (FILE) ); (FILE) = nullptr
+static void CloseInputView(InputView* view) {
+	if (view->mapBase != nullptr) {
+#if defined( _WIN32 )
+		UnmapViewOfFile(view->mapBase);
+#else
+		munmap(view->mapBase, view->mapSize);
+#endif
+		view->mapBase = nullptr;
+		view->mapSize = 0;
+	}
+	view->buffer.clear();
+	view->buffer.shrink_to_fit();
+	view->data = nullptr;
+	view->size = 0;
+}
 
-int main(int argc, char** argv) {
-	Print(
-		"Bin2Obj by Mark \"hogsy\" Sowden <hogsy@oldtimes-software.com>\n"
-		"==============================================================\n\n"
-	);
+/**
+ * An input file shared between every job that reads from it, which is opened
+ * by whichever job gets to it first and closed once the last is done with it.
+ */
+struct SharedInputFile {
+	InputFile file;
+	std::mutex mutex;
+	unsigned int numJobs{ 0 };
+	bool opened{ false };
+	bool failed{ false };
+};
 
-	ParseCommandLine(argc, argv);
+static std::map<std::string, SharedInputFile> sharedInputFiles;
 
-	env.filePath = argv[1];
-	Print("Loading \"%s\"\n", env.filePath);
+static InputFile* AcquireInputFile(const std::string& path) {
+	SharedInputFile& shared = sharedInputFiles.at(path);
+	std::lock_guard<std::mutex> lock(shared.mutex);
+	if (!shared.opened && !shared.failed) {
+		shared.opened = OpenInputFile(&shared.file, path.c_str());
+		shared.failed = !shared.opened;
+	}
+	return shared.opened ? &shared.file : nullptr;
+}
 
-	FILE* file = fopen(env.filePath, "rb");
-	if (file == nullptr) {
-		AbortApp("Failed to open \"%s\"!\n", env.filePath);
-	}
-
-	FileSeek(file, env.startOffset, true);
-
-	while (feof(file) == 0) {
-        Vertex v;
-        bool success = false;
-        switch( env.vertexType ) {
-            default: {
-                if (fread(&v, sizeof(Vertex), 1, file) != 1) {
-                    break;
-                }
-                success = true;
-                break;
-            }
-            case Environment::VertexType::I16: {
-                int16_t coords[3];
-                if (fread(coords, sizeof(int16_t), 3, file) != 3) {
-                    break;
-                }
-                // blergh...
-                v.x = (float) coords[0];
-                v.z = (float) coords[2];
-                v.y = (float) coords[1];
-                success = true;
-                break;
-            }
-        }
-
-        if ( !success ) {
-            Print("Failed to read in vertex at %lu\n", ftell(file));
-            break;
-        }
-
-		v *= env.scale;
-		if (std::isnan(v.x) || std::isnan(v.y) || std::isnan(v.z)) {
-			Warn("Encountered NaN for vertex, ");
-			if (std::isnan(v.x)) { Print("X "); v.x = 0.0f; }
-			if (std::isnan(v.y)) { Print("Y "); v.y = 0.0f; }
-			if (std::isnan(v.z)) { Print("Z "); v.z = 0.0f; }
-			Print("- defaulting to 0.0!\n");
-		}
-		VPrint( "\tx( %f ) y( %f ) z( %f )\n", v.x, v.y, v.z );
-		env.meshVertices.push_back(v);
-		if (env.endOffset > 0 && ftell(file) >= env.endOffset) {
-			break;
+static void ReleaseInputFile(const std::string& path) {
+	SharedInputFile& shared = sharedInputFiles.at(path);
+	std::lock_guard<std::mutex> lock(shared.mutex);
+	if (--shared.numJobs == 0 && shared.opened) {
+		CloseInputFile(&shared.file);
+		shared.opened = false;
+	}
+}
+
+#if defined( BIN2OBJ_SSE2 )
+/**
+ * Packs four XYZ_ registers into twelve contiguous floats.
+ */
+static inline void StoreVertices4(Vertex* out, __m128 v0, __m128 v1, __m128 v2, __m128 v3) {
+	__m128 t0 = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(0, 0, 2, 2));  // z0 z0 x1 x1
+	__m128 t1 = _mm_shuffle_ps(v2, v3, _MM_SHUFFLE(0, 0, 2, 2));  // z2 z2 x3 x3
+	auto* dst = (float*)out;
+	_mm_storeu_ps(dst + 0, _mm_shuffle_ps(v0, t0, _MM_SHUFFLE(2, 0, 1, 0)));  // x0 y0 z0 x1
+	_mm_storeu_ps(dst + 4, _mm_shuffle_ps(v1, v2, _MM_SHUFFLE(1, 0, 2, 1)));  // y1 z1 x2 y2
+	_mm_storeu_ps(dst + 8, _mm_shuffle_ps(t1, v3, _MM_SHUFFLE(2, 1, 2, 0)));  // z2 x3 y3 z3
+}
+
+/**
+ * Reverses the bytes within each 16-bit lane.
+ */
+static inline __m128i ByteSwap16(__m128i v) {
+	return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+/**
+ * Reverses the bytes within each 32-bit lane.
+ */
+static inline __m128i ByteSwap32(__m128i v) {
+#	if defined( __SSSE3__ )
+	return _mm_shuffle_epi8(v, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+#	else
+	v = ByteSwap16(v);
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+#	endif
+}
+
+/**
+ * Loads four floats from p, reversing the bytes of each if Swap is set.
+ */
+template<bool Swap>
+static inline __m128 LoadFloats4(const uint8_t* p) {
+	if constexpr (Swap) {
+		return _mm_castsi128_ps(ByteSwap32(_mm_loadu_si128((const __m128i*)p)));
+	} else {
+		return _mm_loadu_ps((const float*)p);
+	}
+}
+#endif
+
+/**
+ * Reads a T from p, reversing its bytes if Swap is set.
+ */
+template<typename T, bool Swap>
+static inline T LoadScalar(const uint8_t* p) {
+	uint8_t bytes[sizeof(T)];
+	memcpy(bytes, p, sizeof(T));
+	if constexpr (Swap) {
+		std::reverse(bytes, bytes + sizeof(T));
+	}
+	T v;
+	memcpy(&v, bytes, sizeof(T));
+	return v;
+}
+
+#if defined( BIN2OBJ_SSE2 )
+/**
+ * Writes four XYZ_ registers out as vertices i to i + 3, which for the SoA
+ * arrays means i has to be a multiple of 4.
+ */
+static inline void StoreVertices4(Vertex* out, size_t i, __m128 v0, __m128 v1, __m128 v2, __m128 v3) {
+	StoreVertices4(out + i, v0, v1, v2, v3);
+}
+
+static inline void StoreVertices4(VertexArrays* out, size_t i, __m128 v0, __m128 v1, __m128 v2, __m128 v3) {
+	_MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+	_mm_store_ps(out->x + i, v0);
+	_mm_store_ps(out->y + i, v1);
+	_mm_store_ps(out->z + i, v2);
+}
+#endif
+
+static inline void StoreVertex(Vertex* out, size_t i, float x, float y, float z) {
+	out[i].x = x;
+	out[i].y = y;
+	out[i].z = z;
+}
+
+static inline void StoreVertex(VertexArrays* out, size_t i, float x, float y, float z) {
+	out->x[i] = x;
+	out->y[i] = y;
+	out->z[i] = z;
+}
+
+/**
+ * Gathers count float32 XYZ triples, spaced pitch bytes apart, into out, which
+ * is either Vertex or VertexArrays. Swap is for sources of the other byte
+ * order, and a non-zero Pitch stands in for the given pitch as a compile-time
+ * constant.
+ */
+template<bool Swap = false, size_t Pitch = 0, typename Output>
+static void DecodeVerticesF32(const uint8_t* src, size_t count, size_t runtimePitch, float scale, Output* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	// Each load pulls in 4 bytes beyond the triple, which is always covered by
+	// the following vertex, so only the very last vertex needs special care.
+	__m128 s = _mm_set1_ps(scale);
+	for (; i + 4 < count; i += 4) {
+		const uint8_t* p = src + i * pitch;
+		StoreVertices4(out, i,
+		               _mm_mul_ps(LoadFloats4<Swap>(p), s),
+		               _mm_mul_ps(LoadFloats4<Swap>(p + pitch), s),
+		               _mm_mul_ps(LoadFloats4<Swap>(p + pitch * 2), s),
+		               _mm_mul_ps(LoadFloats4<Swap>(p + pitch * 3), s));
+	}
+#endif
+	for (; i < count; ++i) {
+		const uint8_t* p = src + i * pitch;
+		StoreVertex(out, i,
+		            LoadScalar<float, Swap>(p) * scale,
+		            LoadScalar<float, Swap>(p + 4) * scale,
+		            LoadScalar<float, Swap>(p + 8) * scale);
+	}
+}
+
+#if defined( BIN2OBJ_SSE2 )
+/**
+ * Widens the XYZ triple of Int at p into the first three int32 lanes. Reads a
+ * fourth component's worth too, so that must be readable.
+ */
+template<typename Int, bool Swap>
+static inline __m128i LoadIntegers4(const uint8_t* p) {
+	if constexpr (sizeof(Int) == 1) {
+		int32_t bytes;
+		memcpy(&bytes, p, sizeof(bytes));
+		__m128i v = _mm_cvtsi32_si128(bytes);
+#	if defined( __SSE4_1__ )
+		if constexpr (std::is_signed_v<Int>) {
+			return _mm_cvtepi8_epi32(v);
+		} else {
+			return _mm_cvtepu8_epi32(v);
 		}
-		int r = fseek(file, ( long ) env.stride, SEEK_CUR);
-		if (env.stride > 0 && r != 0) {
-			break;
+#	else
+		v = _mm_unpacklo_epi8(v, v);
+		v = _mm_unpacklo_epi16(v, v);
+		if constexpr (std::is_signed_v<Int>) {
+			return _mm_srai_epi32(v, 24);
+		} else {
+			return _mm_srli_epi32(v, 24);
+		}
+#	endif
+	} else if constexpr (sizeof(Int) == 2) {
+		__m128i v = _mm_loadl_epi64((const __m128i*)p);
+		if constexpr (Swap) {
+			v = ByteSwap16(v);
 		}
+#	if defined( __SSE4_1__ )
+		if constexpr (std::is_signed_v<Int>) {
+			return _mm_cvtepi16_epi32(v);
+		} else {
+			return _mm_cvtepu16_epi32(v);
+		}
+#	else
+		v = _mm_unpacklo_epi16(v, v);
+		if constexpr (std::is_signed_v<Int>) {
+			return _mm_srai_epi32(v, 16);
+		} else {
+			return _mm_srli_epi32(v, 16);
+		}
+#	endif
+	} else {
+		__m128i v = _mm_loadu_si128((const __m128i*)p);
+		if constexpr (Swap) {
+			v = ByteSwap32(v);
+		}
+		return v;
 	}
-	Print( "Loaded in %d vertices\n", (int)env.meshVertices.size() );
-	// If both start and end offsets are defined for the faces, load those in.
-	unsigned long faceBytes = env.faceEndOffset - env.faceStartOffset;
-	if( faceBytes > 0 ) {
-		Print("Attempting to read in faces...\n");
-		FileSeek( file, env.faceStartOffset, true );
-
-        unsigned int varSize;
-        switch( env.faceType ) {
-            default:
-                varSize = sizeof( uint32_t );
-                break;
-            case Environment::FaceType::I16:
-                varSize = sizeof( uint16_t );
-                break;
-        }
-
-		// Since we require both the start and end, we know how much data we want.
-        unsigned int numFaces = faceBytes / (varSize * (env.faceQuad ? 4 : 3));
-		env.meshFaces.reserve( numFaces );
-		for( unsigned int i = 0; i < numFaces; ++i ) {
-            // Quick crap to deal with stride
-            long offset = ftell( file );
-            if ( offset > env.faceEndOffset )
-                break;
-
-			Face f;
-            switch ( env.faceType ) {
-                default: {
-                    if ( env.faceQuad ) {
-                        if (fread(&f, sizeof(Face), 1, file) != 1 ) {
-                            Warn( "Failed to read in face (%u), some faces may be missing or incorrect!\n", i );
-                        }
-                    } else {
-                        uint32_t x, y, z;
-                        if (fread(&x, sizeof(uint32_t), 1, file) != 1) {
-                            Warn("Failed to load in face element x (%u), some faces may be missing or incorrect!\n",
-                                 i);
-                            break;
-                        }
-                        f.x = x;
-                        if (fread(&y, sizeof(uint32_t), 1, file) != 1) {
-                            Warn("Failed to load in face element y (%u), some faces may be missing or incorrect!\n",
-                                 i);
-                            break;
-                        }
-                        f.y = y;
-                        if (fread(&z, sizeof(uint32_t), 1, file) != 1) {
-                            Warn("Failed to load in face element z (%u), some faces may be missing or incorrect!\n",
-                                 i);
-                            break;
-                        }
-                        f.z = z;
-                    }
-                    break;
-                }
-                case Environment::FaceType::I16: {
-                    uint16_t x, y, z;
-                    if (fread(&x, sizeof(uint16_t), 1, file) != 1) {
-                        Warn("Failed to load in face element x (%u), some faces may be missing or incorrect!\n", i );
-                        break;
-                    }
-                    f.x = x;
-                    if (fread(&y, sizeof(uint16_t), 1, file) != 1) {
-                        Warn("Failed to load in face element y (%u), some faces may be missing or incorrect!\n", i );
-                        break;
-                    }
-                    f.y = y;
-                    if (fread(&z, sizeof(uint16_t), 1, file) != 1) {
-                        Warn("Failed to load in face element z (%u), some faces may be missing or incorrect!\n", i );
-                        break;
-                    }
-                    f.z = z;
-                    if ( env.faceQuad ) {
-                        uint16_t w;
-                        if ( fread( &w, sizeof( uint16_t ), 1, file ) != 1 ) {
-                            Warn("Failed to load in face element x (%u), some faces may be missing or incorrect!\n", i );
-                            break;
-                        }
-                        f.w = w;
-                    }
-                    break;
-                }
-            }
-
-            if ( env.faceQuad ) {
-                VPrint("\tx( %u ) y( %u ) z( %u ) w( %u )\n", f.x, f.y, f.z, f.w);
-                if (f.x >= env.meshVertices.size() || f.y >= env.meshVertices.size() ||
-                    f.z >= env.meshVertices.size() || f.w >= env.meshVertices.size() ) {
-                    Warn("Encountered out of bound vertex index, ");
-                    if (f.x >= env.meshVertices.size()) {
-                        Print("X (%u)", f.x);
-                        f.x = 0;
-                    }
-                    if (f.y >= env.meshVertices.size()) {
-                        Print("Y (%u)", f.y);
-                        f.y = 0;
-                    }
-                    if (f.z >= env.meshVertices.size()) {
-                        Print("Z (%u)", f.z);
-                        f.z = 0;
-                    }
-                    if (f.z >= env.meshVertices.size()) {
-                        Print("W (%u)", f.w);
-                        f.w = 0;
-                    }
-                    Print("- defaulting to 0!\n");
-                }
-            } else {
-                VPrint("\tx( %d ) y( %d ) z( %d )\n", f.x, f.y, f.z);
-                if (f.x >= env.meshVertices.size() || f.y >= env.meshVertices.size() ||
-                    f.z >= env.meshVertices.size()) {
-                    Warn("Encountered out of bound vertex index, ");
-                    if (f.x >= env.meshVertices.size()) {
-                        Print("X (%u)", f.x);
-                        f.x = 0;
-                    }
-                    if (f.y >= env.meshVertices.size()) {
-                        Print("Y (%u)", f.y);
-                        f.y = 0;
-                    }
-                    if (f.z >= env.meshVertices.size()) {
-                        Print("Z (%u)", f.z);
-                        f.z = 0;
-                    }
-                    Print("- defaulting to 0!\n");
-                }
-            }
-			env.meshFaces.push_back(f);
-			int r = fseek( file, ( long ) env.faceStride, SEEK_CUR );
-			if( env.faceStride > 0 && r != 0 ) {
-				break;
+}
+#endif
+
+/**
+ * Converts count XYZ triples of the integer type Int, spaced pitch bytes
+ * apart, into float vertices. Each component is clamped to minimum before
+ * it's scaled, which keeps the most negative value of the normalised signed
+ * formats at -1.
+ */
+template<typename Int, bool Swap = false, size_t Pitch = 0, typename Output>
+static void DecodeVerticesInt(const uint8_t* src, size_t count, size_t runtimePitch, float scale, float minimum, Output* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	size_t i = 0;
+#if defined( __AVX2__ )
+	if constexpr (sizeof(Int) == 2) {
+		// Two triples per 128-bit load pair, widened and converted 8 lanes at a time.
+		__m256 s8 = _mm256_set1_ps(scale);
+		__m256 m8 = _mm256_set1_ps(minimum);
+		for (; i + 8 < count; i += 8) {
+			const uint8_t* p = src + i * pitch;
+			__m256 v[4];
+			for (unsigned int j = 0; j < 4; ++j, p += pitch * 2) {
+				__m128i pair = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i*)p),
+				                                  _mm_loadl_epi64((const __m128i*)(p + pitch)));
+				if constexpr (Swap) {
+					pair = ByteSwap16(pair);
+				}
+				__m256i wide;
+				if constexpr (std::is_signed_v<Int>) {
+					wide = _mm256_cvtepi16_epi32(pair);
+				} else {
+					wide = _mm256_cvtepu16_epi32(pair);
+				}
+				v[j] = _mm256_mul_ps(_mm256_max_ps(_mm256_cvtepi32_ps(wide), m8), s8);
 			}
+			StoreVertices4(out, i,
+			               _mm256_castps256_ps128(v[0]), _mm256_extractf128_ps(v[0], 1),
+			               _mm256_castps256_ps128(v[1]), _mm256_extractf128_ps(v[1], 1));
+			StoreVertices4(out, i + 4,
+			               _mm256_castps256_ps128(v[2]), _mm256_extractf128_ps(v[2], 1),
+			               _mm256_castps256_ps128(v[3]), _mm256_extractf128_ps(v[3], 1));
 		}
-		Print( "Loaded in %d faces\n", (int)env.meshFaces.size() );
 	}
-	CloseFile(file);
+#endif
+#if defined( BIN2OBJ_SSE2 )
+	__m128 s = _mm_set1_ps(scale);
+	__m128 m = _mm_set1_ps(minimum);
+	auto Convert = [s, m](__m128i v) {
+		return _mm_mul_ps(_mm_max_ps(_mm_cvtepi32_ps(v), m), s);
+	};
+	for (; i + 4 < count; i += 4) {
+		const uint8_t* p = src + i * pitch;
+		StoreVertices4(out, i,
+		               Convert(LoadIntegers4<Int, Swap>(p)),
+		               Convert(LoadIntegers4<Int, Swap>(p + pitch)),
+		               Convert(LoadIntegers4<Int, Swap>(p + pitch * 2)),
+		               Convert(LoadIntegers4<Int, Swap>(p + pitch * 3)));
+	}
+#endif
+	for (; i < count; ++i) {
+		const uint8_t* p = src + i * pitch;
+		StoreVertex(out, i,
+		            std::max((float)LoadScalar<Int, Swap>(p), minimum) * scale,
+		            std::max((float)LoadScalar<Int, Swap>(p + sizeof(Int)), minimum) * scale,
+		            std::max((float)LoadScalar<Int, Swap>(p + sizeof(Int) * 2), minimum) * scale);
+	}
+}
 
-	file = fopen(env.outPath, "w");
-	fprintf(file, "# Generated by Bin2Obj, by Mark \"hogsy\" Sowden <hogsy@oldtimes-software.com>\n\n");
-	for (auto& vertex : env.meshVertices) {
-		fprintf(file, "v %f %f %f\n", vertex.x, vertex.y, vertex.z);
-	}
-
-    unsigned int numFaceElements = env.faceQuad ? 4 : 3;
-	for( auto &face : env.meshFaces ) {
-        auto *fv = (unsigned int *) &face;
-        bool invalid = false;
-        for (unsigned int i = 0; i < numFaceElements; ++i) {
-            for (unsigned int j = 0; j < numFaceElements; ++j) {
-                if (fv[i] == fv[j] && i != j) {
-                    VPrint("Invalid face indices found (%u %u %u)!\n", fv[0], fv[1], fv[2]);
-                    invalid = true;
-                    break;
-                }
-                if (invalid) break;
-            }
-        }
-
-        if (invalid)
-            continue;
-
-        fprintf(file, "f ");
-        for (unsigned int i = 0; i < numFaceElements; ++i) {
-            fprintf(file, i != (numFaceElements - 1) ? "%d " : "%d\n", fv[i] + 1);
-        }
-	}
-	CloseFile(file);
-
-	Print("Wrote \"%s\"!\n", env.outPath);
+/**
+ * Converts an IEEE half into a float.
+ */
+static inline float HalfToFloat(uint16_t half) {
+	uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+	uint32_t magnitude = (uint32_t)(half & 0x7FFF) << 13;
+	uint32_t bits;
+	if (magnitude >= (0x7C00u << 13)) {
+		// Infinity or NaN, which only need the exponent maxing out.
+		bits = magnitude | 0x7F800000;
+	} else {
+		// Scaling by 2^112 rebiases the exponent, and sorts out denormals too.
+		float f;
+		memcpy(&f, &magnitude, sizeof(f));
+		f *= 0x1p112f;
+		memcpy(&bits, &f, sizeof(bits));
+	}
+	bits |= sign;
+
+	float f;
+	memcpy(&f, &bits, sizeof(f));
+	return f;
+}
+
+#if defined( BIN2OBJ_SSE2 )
+/**
+ * Converts the halfs held in the low 16 bits of each 32-bit lane into floats,
+ * the same way as HalfToFloat.
+ */
+static inline __m128 HalfsToFloats4(__m128i v) {
+	__m128i sign = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x8000)), 16);
+	__m128i magnitude = _mm_slli_epi32(_mm_and_si128(v, _mm_set1_epi32(0x7FFF)), 13);
+	__m128i finite = _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(magnitude), _mm_set1_ps(0x1p112f)));
+	__m128i nonFinite = _mm_or_si128(magnitude, _mm_set1_epi32(0x7F800000));
+	__m128i isNonFinite = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32((0x7C00 << 13) - 1));
+	__m128i bits = _mm_or_si128(_mm_andnot_si128(isNonFinite, finite), _mm_and_si128(isNonFinite, nonFinite));
+	return _mm_castsi128_ps(_mm_or_si128(bits, sign));
+}
+
+/**
+ * Loads four halfs from p and converts them into floats.
+ */
+template<bool Swap>
+static inline __m128 LoadHalfs4(const uint8_t* p) {
+	__m128i v = _mm_loadl_epi64((const __m128i*)p);
+	if constexpr (Swap) {
+		v = ByteSwap16(v);
+	}
+#	if defined( __F16C__ )
+	return _mm_cvtph_ps(v);
+#	else
+	return HalfsToFloats4(_mm_unpacklo_epi16(v, _mm_setzero_si128()));
+#	endif
+}
+#endif
+
+/**
+ * Converts count IEEE half XYZ triples, spaced pitch bytes apart, into scaled
+ * float vertices.
+ */
+template<bool Swap = false, size_t Pitch = 0, typename Output>
+static void DecodeVerticesF16(const uint8_t* src, size_t count, size_t runtimePitch, float scale, Output* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	__m128 s = _mm_set1_ps(scale);
+	for (; i + 4 < count; i += 4) {
+		const uint8_t* p = src + i * pitch;
+		StoreVertices4(out, i,
+		               _mm_mul_ps(LoadHalfs4<Swap>(p), s),
+		               _mm_mul_ps(LoadHalfs4<Swap>(p + pitch), s),
+		               _mm_mul_ps(LoadHalfs4<Swap>(p + pitch * 2), s),
+		               _mm_mul_ps(LoadHalfs4<Swap>(p + pitch * 3), s));
+	}
+#endif
+	for (; i < count; ++i) {
+		const uint8_t* p = src + i * pitch;
+		StoreVertex(out, i,
+		            HalfToFloat(LoadScalar<uint16_t, Swap>(p)) * scale,
+		            HalfToFloat(LoadScalar<uint16_t, Swap>(p + 2)) * scale,
+		            HalfToFloat(LoadScalar<uint16_t, Swap>(p + 4)) * scale);
+	}
+}
+
+#if defined( BIN2OBJ_SSE2 )
+/**
+ * Writes the X, Y and Z of vertices i to i + 3 out from a register each.
+ */
+static inline void StoreComponents4(Vertex* out, size_t i, __m128 x, __m128 y, __m128 z) {
+	__m128 w = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	StoreVertices4(out + i, x, y, z, w);
+}
+
+static inline void StoreComponents4(VertexArrays* out, size_t i, __m128 x, __m128 y, __m128 z) {
+	_mm_store_ps(out->x + i, x);
+	_mm_store_ps(out->y + i, y);
+	_mm_store_ps(out->z + i, z);
+}
+
+/**
+ * Gathers the 32-bit words of four vertices, pitch bytes apart, into one register.
+ */
+template<bool Swap>
+static inline __m128i LoadWords4(const uint8_t* p, size_t pitch) {
+	int32_t words[4];
+	for (unsigned int j = 0; j < 4; ++j) {
+		memcpy(&words[j], p + j * pitch, sizeof(int32_t));
+	}
+	__m128i v = _mm_loadu_si128((const __m128i*)words);
+	if constexpr (Swap) {
+		v = ByteSwap32(v);
+	}
+	return v;
+}
+#endif
+
+/**
+ * Unpacks count XYZ triples packed into 32-bit words as 10:10:10:2, spaced
+ * pitch bytes apart, into normalised float vertices. The 2-bit W is ignored.
+ */
+template<bool Signed, bool Swap = false, size_t Pitch = 0, typename Output>
+static void DecodeVertices10_10_10_2(const uint8_t* src, size_t count, size_t runtimePitch, float scale, Output* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	const float minimum = Signed ? -511.0f : 0.0f;
+	scale /= Signed ? 511.0f : 1023.0f;
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	// Four vertices a register, with each field shifted down to the bottom of the lane.
+	__m128 s = _mm_set1_ps(scale);
+	__m128 m = _mm_set1_ps(minimum);
+	const __m128i fieldMask = _mm_set1_epi32(0x3FF);
+	auto Convert = [s, m](__m128i v) {
+		return _mm_mul_ps(_mm_max_ps(_mm_cvtepi32_ps(v), m), s);
+	};
+	for (; i + 4 <= count; i += 4) {
+		__m128i v = LoadWords4<Swap>(src + i * pitch, pitch);
+		if constexpr (Signed) {
+			StoreComponents4(out, i,
+			                 Convert(_mm_srai_epi32(_mm_slli_epi32(v, 22), 22)),
+			                 Convert(_mm_srai_epi32(_mm_slli_epi32(v, 12), 22)),
+			                 Convert(_mm_srai_epi32(_mm_slli_epi32(v, 2), 22)));
+		} else {
+			StoreComponents4(out, i,
+			                 Convert(_mm_and_si128(v, fieldMask)),
+			                 Convert(_mm_and_si128(_mm_srli_epi32(v, 10), fieldMask)),
+			                 Convert(_mm_and_si128(_mm_srli_epi32(v, 20), fieldMask)));
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		uint32_t v = LoadScalar<uint32_t, Swap>(src + i * pitch);
+		float c[3];
+		for (unsigned int j = 0; j < 3; ++j) {
+			if constexpr (Signed) {
+				c[j] = (float)((int32_t)(v << (22 - j * 10)) >> 22);
+			} else {
+				c[j] = (float)((v >> (j * 10)) & 0x3FF);
+			}
+		}
+		StoreVertex(out, i,
+		            std::max(c[0], minimum) * scale,
+		            std::max(c[1], minimum) * scale,
+		            std::max(c[2], minimum) * scale);
+	}
+}
+
+/**
+ * Unpacks count XYZ triples packed into 32-bit words as 11:11:10 unsigned
+ * floats, spaced pitch bytes apart, into float vertices. Each field shares a
+ * half's exponent, so they're widened into halfs and converted from there.
+ */
+template<bool Swap = false, size_t Pitch = 0, typename Output>
+static void DecodeVertices11_11_10(const uint8_t* src, size_t count, size_t runtimePitch, float scale, Output* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	__m128 s = _mm_set1_ps(scale);
+	const __m128i mask11 = _mm_set1_epi32(0x7FF << 4);
+	const __m128i mask10 = _mm_set1_epi32(0x3FF << 5);
+	for (; i + 4 <= count; i += 4) {
+		__m128i v = LoadWords4<Swap>(src + i * pitch, pitch);
+		StoreComponents4(out, i,
+		                 _mm_mul_ps(HalfsToFloats4(_mm_and_si128(_mm_slli_epi32(v, 4), mask11)), s),
+		                 _mm_mul_ps(HalfsToFloats4(_mm_and_si128(_mm_srli_epi32(v, 7), mask11)), s),
+		                 _mm_mul_ps(HalfsToFloats4(_mm_and_si128(_mm_srli_epi32(v, 17), mask10)), s));
+	}
+#endif
+	for (; i < count; ++i) {
+		uint32_t v = LoadScalar<uint32_t, Swap>(src + i * pitch);
+		StoreVertex(out, i,
+		            HalfToFloat((uint16_t)((v & 0x7FF) << 4)) * scale,
+		            HalfToFloat((uint16_t)(((v >> 11) & 0x7FF) << 4)) * scale,
+		            HalfToFloat((uint16_t)(((v >> 22) & 0x3FF) << 5)) * scale);
+	}
+}
+
+/**
+ * Interleaves the component arrays back into out.
+ */
+static void StoreVertexArrays(const VertexArrays& in, Vertex* out) {
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	for (; i + 4 <= in.count; i += 4) {
+		__m128 v0 = _mm_load_ps(in.x + i);
+		__m128 v1 = _mm_load_ps(in.y + i);
+		__m128 v2 = _mm_load_ps(in.z + i);
+		__m128 v3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+		StoreVertices4(out + i, v0, v1, v2, v3);
+	}
+#endif
+	for (; i < in.count; ++i) {
+		out[i].x = in.x[i];
+		out[i].y = in.y[i];
+		out[i].z = in.z[i];
+	}
+}
+
+/**
+ * Widens count faces of NumElements indices each, spaced pitch bytes apart,
+ * into out, reversing the bytes of each index if Swap is set. The fourth
+ * element of a triangle is left as 0.
+ */
+template<typename Index, unsigned int NumElements, bool Swap = false, size_t Pitch = 0>
+static void WidenFaces(const uint8_t* src, size_t count, size_t runtimePitch, Face* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	// Always loads four indices, which for triangles runs into the following
+	// face, so the last one is left to the plain loop.
+	const __m128i elementMask = _mm_setr_epi32(-1, -1, -1, NumElements == 4 ? -1 : 0);
+	for (; i + 1 < count; ++i) {
+		const uint8_t* p = src + i * pitch;
+		__m128i v;
+		if constexpr (sizeof(Index) == 2) {
+			v = _mm_loadl_epi64((const __m128i*)p);
+			if constexpr (Swap) {
+				v = ByteSwap16(v);
+			}
+			v = _mm_unpacklo_epi16(v, _mm_setzero_si128());
+		} else {
+			v = _mm_loadu_si128((const __m128i*)p);
+			if constexpr (Swap) {
+				v = ByteSwap32(v);
+			}
+		}
+		_mm_storeu_si128((__m128i*)&out[i], _mm_and_si128(v, elementMask));
+	}
+#endif
+	for (; i < count; ++i) {
+		const uint8_t* p = src + i * pitch;
+		auto* fv = (unsigned int*)&out[i];
+		for (unsigned int j = 0; j < NumElements; ++j) {
+			fv[j] = LoadScalar<Index, Swap>(p + j * sizeof(Index));
+		}
+	}
+}
+
+/**
+ * Calls kernel with the pitch as a compile-time constant if it's one of the
+ * common ones, so the kernel's addressing folds down, or with 0 otherwise.
+ */
+template<typename Kernel>
+static inline void DispatchPitch(size_t pitch, const Kernel& kernel) {
+	switch (pitch) {
+		case 3: kernel(std::integral_constant<size_t, 3>()); break;
+		case 4: kernel(std::integral_constant<size_t, 4>()); break;
+		case 6: kernel(std::integral_constant<size_t, 6>()); break;
+		case 8: kernel(std::integral_constant<size_t, 8>()); break;
+		case 12: kernel(std::integral_constant<size_t, 12>()); break;
+		case 16: kernel(std::integral_constant<size_t, 16>()); break;
+		case 20: kernel(std::integral_constant<size_t, 20>()); break;
+		case 24: kernel(std::integral_constant<size_t, 24>()); break;
+		case 32: kernel(std::integral_constant<size_t, 32>()); break;
+		default: kernel(std::integral_constant<size_t, 0>()); break;
+	}
+}
+
+/**
+ * Tally of the vertex components zeroed by SanitizeVertices.
+ */
+struct SanitizeReport {
+	size_t numNaN{ 0 };
+	size_t numInfinite{ 0 };
+	size_t numDenormal{ 0 };
+
+	// Indices of the first few vertices that needed fixing up.
+	static constexpr unsigned int MAX_OFFENDERS = 8;
+	size_t offenders[MAX_OFFENDERS];
+	unsigned int numOffenders{ 0 };
+
+	// Added onto each offender, for when the vertices come in a window at a time.
+	size_t firstVertex{ 0 };
+
+	void AddOffender(size_t vertex) {
+		vertex += firstVertex;
+		// Normals and texture coordinates are checked after the positions, so
+		// the same vertex can come back round.
+		if (std::find(offenders, offenders + numOffenders, vertex) != offenders + numOffenders) {
+			return;
+		}
+		if (numOffenders < MAX_OFFENDERS) {
+			offenders[numOffenders++] = vertex;
+		}
+	}
+};
+
+/**
+ * Zeroes any NaN components in the given interleaved vertex data, with
+ * componentsPerVertex floats to each vertex, and optionally any infinite or
+ * denormal ones too.
+ */
+static void SanitizeComponents(float* components, size_t numComponents, unsigned int componentsPerVertex, bool flushNonFinite,
+                               SanitizeReport* report) {
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 infinity = _mm_set1_ps(INFINITY);
+	const __m128 smallest = _mm_set1_ps(FLT_MIN);
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= numComponents; i += 4) {
+		__m128 v = _mm_loadu_ps(components + i);
+		__m128 nanMask = _mm_cmpunord_ps(v, v);
+		__m128 infMask = zero, denMask = zero;
+		if (flushNonFinite) {
+			__m128 a = _mm_and_ps(v, absMask);
+			infMask = _mm_cmpeq_ps(a, infinity);
+			denMask = _mm_and_ps(_mm_cmplt_ps(a, smallest), _mm_cmpneq_ps(a, zero));
+		}
+
+		__m128 badMask = _mm_or_ps(nanMask, _mm_or_ps(infMask, denMask));
+		int bad = _mm_movemask_ps(badMask);
+		if (bad == 0) {
+			continue;
+		}
+
+		int nans = _mm_movemask_ps(nanMask);
+		int infs = _mm_movemask_ps(infMask);
+		int dens = _mm_movemask_ps(denMask);
+		for (unsigned int lane = 0; lane < 4; ++lane) {
+			report->numNaN += (nans >> lane) & 1;
+			report->numInfinite += (infs >> lane) & 1;
+			report->numDenormal += (dens >> lane) & 1;
+			if ((bad >> lane) & 1) {
+				report->AddOffender((i + lane) / componentsPerVertex);
+			}
+		}
+		_mm_storeu_ps(components + i, _mm_andnot_ps(badMask, v));
+	}
+#endif
+	for (; i < numComponents; ++i) {
+		float v = components[i];
+		bool isNaN = std::isnan(v);
+		bool isInfinite = flushNonFinite && std::isinf(v);
+		bool isDenormal = flushNonFinite && std::fpclassify(v) == FP_SUBNORMAL;
+		if (!isNaN && !isInfinite && !isDenormal) {
+			continue;
+		}
+
+		report->numNaN += isNaN;
+		report->numInfinite += isInfinite;
+		report->numDenormal += isDenormal;
+		report->AddOffender(i / componentsPerVertex);
+		components[i] = 0.0f;
+	}
+}
+
+static void SanitizeVertices(Vertex* vertices, size_t count, bool flushNonFinite, SanitizeReport* report) {
+	SanitizeComponents((float*)vertices, count * 3, 3, flushNonFinite, report);
+}
+
+static void SanitizeTexCoords(TexCoord* texCoords, size_t count, bool flushNonFinite, SanitizeReport* report) {
+	SanitizeComponents((float*)texCoords, count * 2, 2, flushNonFinite, report);
+}
+
+/**
+ * Same as above, but over separate component arrays, which lets each lane
+ * stand for a whole vertex.
+ */
+static void SanitizeVertices(VertexArrays* vertices, bool flushNonFinite, SanitizeReport* report) {
+	float* components[3] = { vertices->x, vertices->y, vertices->z };
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	static const uint8_t NUM_LANES_SET[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 infinity = _mm_set1_ps(INFINITY);
+	const __m128 smallest = _mm_set1_ps(FLT_MIN);
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= vertices->count; i += 4) {
+		int bad = 0;
+		for (float* c : components) {
+			__m128 v = _mm_load_ps(c + i);
+			__m128 nanMask = _mm_cmpunord_ps(v, v);
+			__m128 infMask = zero, denMask = zero;
+			if (flushNonFinite) {
+				__m128 a = _mm_and_ps(v, absMask);
+				infMask = _mm_cmpeq_ps(a, infinity);
+				denMask = _mm_and_ps(_mm_cmplt_ps(a, smallest), _mm_cmpneq_ps(a, zero));
+			}
+
+			__m128 badMask = _mm_or_ps(nanMask, _mm_or_ps(infMask, denMask));
+			int badComponents = _mm_movemask_ps(badMask);
+			if (badComponents == 0) {
+				continue;
+			}
+
+			report->numNaN += NUM_LANES_SET[_mm_movemask_ps(nanMask)];
+			report->numInfinite += NUM_LANES_SET[_mm_movemask_ps(infMask)];
+			report->numDenormal += NUM_LANES_SET[_mm_movemask_ps(denMask)];
+			_mm_store_ps(c + i, _mm_andnot_ps(badMask, v));
+			bad |= badComponents;
+		}
+
+		for (unsigned int lane = 0; lane < 4; ++lane) {
+			if ((bad >> lane) & 1) {
+				report->AddOffender(i + lane);
+			}
+		}
+	}
+#endif
+	for (; i < vertices->count; ++i) {
+		for (float* c : components) {
+			float v = c[i];
+			bool isNaN = std::isnan(v);
+			bool isInfinite = flushNonFinite && std::isinf(v);
+			bool isDenormal = flushNonFinite && std::fpclassify(v) == FP_SUBNORMAL;
+			if (!isNaN && !isInfinite && !isDenormal) {
+				continue;
+			}
+
+			report->numNaN += isNaN;
+			report->numInfinite += isInfinite;
+			report->numDenormal += isDenormal;
+			report->AddOffender(i);
+			c[i] = 0.0f;
+		}
+	}
+}
+
+/**
+ * Fixed set of worker threads that the calling thread hands loops out to.
+ */
+class ThreadPool {
+public:
+	explicit ThreadPool(unsigned int numThreads) {
+		// The calling thread always takes part, so we need one less worker.
+		for (unsigned int i = 1; i < numThreads; ++i) {
+			threads.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			shutdown = true;
+		}
+		wake.notify_all();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+
+	unsigned int GetNumThreads() const { return (unsigned int)threads.size() + 1; }
+
+	/**
+	 * Whether the calling thread is running a ParallelFor task, in which case
+	 * any ParallelFor it makes will run in place on just this thread.
+	 */
+	static bool IsInParallelFor() { return inParallelFor; }
+
+	/**
+	 * Calls func for every index in [0, count), returning once all are done.
+	 * Calls made from within another ParallelFor are simply run in place.
+	 */
+	void ParallelFor(size_t count, const std::function<void(size_t)>& func) {
+		if (threads.empty() || inParallelFor || count <= 1) {
+			for (size_t i = 0; i < count; ++i) {
+				func(i);
+			}
+			return;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		task = &func;
+		taskCount = count;
+		next = 0;
+		busy = (unsigned int)threads.size();
+		generation++;
+		wake.notify_all();
+		lock.unlock();
+
+		inParallelFor = true;
+		RunTask();
+		inParallelFor = false;
+
+		lock.lock();
+		done.wait(lock, [this] { return busy == 0; });
+		task = nullptr;
+	}
+
+private:
+	void RunTask() {
+		for (size_t i = next++; i < taskCount; i = next++) {
+			(*task)(i);
+		}
+	}
+
+	void WorkerLoop() {
+		inParallelFor = true;
+		uint64_t seenGeneration = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		for (;;) {
+			wake.wait(lock, [&] { return shutdown || generation != seenGeneration; });
+			if (shutdown) {
+				return;
+			}
+			seenGeneration = generation;
+
+			lock.unlock();
+			RunTask();
+			lock.lock();
+
+			if (--busy == 0) {
+				done.notify_all();
+			}
+		}
+	}
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake, done;
+	bool shutdown{ false };
+	uint64_t generation{ 0 };
+	unsigned int busy{ 0 };
+
+	const std::function<void(size_t)>* task{ nullptr };
+	size_t taskCount{ 0 };
+	std::atomic<size_t> next{ 0 };
+
+	static thread_local bool inParallelFor;
+};
+
+thread_local bool ThreadPool::inParallelFor = false;
+
+static ThreadPool& GetThreadPool() {
+	static ThreadPool threadPool(env.numThreads > 0 ? env.numThreads : std::max(1u, std::thread::hardware_concurrency()));
+	return threadPool;
+}
+
+// Worst case for a single element written by FormatFloat.
+static constexpr size_t MAX_FLOAT_CHARS = 64;
+static constexpr int MAX_PRECISION = 9;
+
+/**
+ * Writes out the given float, either as the shortest string which reads back
+ * to the same value or with a fixed number of decimal places.
+ */
+static inline char* FormatFloat(char* dst, float v, int precision) {
+	char* end = dst + MAX_FLOAT_CHARS + MAX_PRECISION;
+	if (precision < 0) {
+		return std::to_chars(dst, end, v).ptr;
+	}
+	return std::to_chars(dst, end, v, std::chars_format::fixed, precision).ptr;
+}
+
+static inline char* FormatIndex(char* dst, uint64_t v) {
+	return std::to_chars(dst, dst + 20, v).ptr;
+}
+
+/**
+ * Returns true if the face references the same vertex more than once.
+ */
+static inline bool IsDegenerateFace(const Face& face, unsigned int numFaceElements) {
+	bool degenerate = face.x == face.y || face.y == face.z || face.x == face.z;
+	if (numFaceElements == 4) {
+		degenerate |= face.w == face.x || face.w == face.y || face.w == face.z;
+	}
+	return degenerate;
+}
+
+/**
+ * Drops any degenerate faces, compacting the rest down in place. Returns the
+ * number dropped.
+ */
+static size_t FilterDegenerateFaces(std::vector<Face>* faces, unsigned int numFaceElements) {
+	static_assert(sizeof(Face) == 16, "Face is expected to be four packed 32-bit indices!");
+
+	Face* f = faces->data();
+	size_t count = faces->size();
+	size_t numKept = 0;
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	// Transpose four faces so each register holds one element from all of them,
+	// then compare every pair of elements at once.
+	bool quad = numFaceElements == 4;
+	for (; i + 4 <= count; i += 4) {
+		__m128 r0 = _mm_loadu_ps((const float*)&f[i + 0]);
+		__m128 r1 = _mm_loadu_ps((const float*)&f[i + 1]);
+		__m128 r2 = _mm_loadu_ps((const float*)&f[i + 2]);
+		__m128 r3 = _mm_loadu_ps((const float*)&f[i + 3]);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		__m128i x = _mm_castps_si128(r0), y = _mm_castps_si128(r1);
+		__m128i z = _mm_castps_si128(r2), w = _mm_castps_si128(r3);
+
+		__m128i same = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(x, y), _mm_cmpeq_epi32(y, z)), _mm_cmpeq_epi32(x, z));
+		if (quad) {
+			same = _mm_or_si128(same, _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi32(w, x), _mm_cmpeq_epi32(w, y)),
+			                                       _mm_cmpeq_epi32(w, z)));
+		}
+
+		int degenerate = _mm_movemask_ps(_mm_castsi128_ps(same));
+		for (unsigned int lane = 0; lane < 4; ++lane) {
+			f[numKept] = f[i + lane];
+			numKept += ((degenerate >> lane) & 1) ^ 1;
+		}
+	}
+#endif
+	for (; i < count; ++i) {
+		f[numKept] = f[i];
+		numKept += !IsDegenerateFace(f[i], numFaceElements);
+	}
+
+	faces->resize(numKept);
+	return count - numKept;
+}
+
+static constexpr size_t MAX_VERTEX_CHARS = 6 + 3 * (MAX_FLOAT_CHARS + MAX_PRECISION);
+// Each element can be written as "index/index/index".
+static constexpr size_t MAX_FACE_CHARS = 2 + 4 * 3 * 21;
+// What the buffers start out sized for per line, as the worst case is far
+// bigger than what's usually written. They grow from there if need be.
+static constexpr size_t TYPICAL_LINE_CHARS = 48;
+
+/**
+ * Makes sure out has room for a line of up to maxChars at p, growing it if
+ * not, and returns where p is now.
+ */
+static inline char* ReserveLine(std::vector<char>* out, char* p, size_t maxChars) {
+	size_t used = p - out->data();
+	if (out->size() - used < maxChars) {
+		out->resize(std::max(out->size() * 2, used + maxChars));
+		p = out->data() + used;
+	}
+	return p;
+}
+
+/**
+ * Appends lines for the given vertices to out, each starting with keyword,
+ * which is "v" or "vn".
+ */
+static void FormatVertices(const Vertex* vertices, size_t count, int precision, const char* keyword, std::vector<char>* out) {
+	out->resize(count * TYPICAL_LINE_CHARS);
+	char* p = out->data();
+	for (size_t i = 0; i < count; ++i) {
+		p = ReserveLine(out, p, MAX_VERTEX_CHARS);
+		for (const char* k = keyword; *k != '\0'; ++k) {
+			*p++ = *k;
+		}
+		*p++ = ' ';
+		p = FormatFloat(p, vertices[i].x, precision);
+		*p++ = ' ';
+		p = FormatFloat(p, vertices[i].y, precision);
+		*p++ = ' ';
+		p = FormatFloat(p, vertices[i].z, precision);
+		*p++ = '\n';
+	}
+	out->resize(p - out->data());
+}
+
+/**
+ * Appends "vt" lines for the given texture coordinates to out.
+ */
+static void FormatTexCoords(const TexCoord* texCoords, size_t count, int precision, std::vector<char>* out) {
+	out->resize(count * TYPICAL_LINE_CHARS);
+	char* p = out->data();
+	for (size_t i = 0; i < count; ++i) {
+		p = ReserveLine(out, p, MAX_VERTEX_CHARS);
+		*p++ = 'v';
+		*p++ = 't';
+		*p++ = ' ';
+		p = FormatFloat(p, texCoords[i].u, precision);
+		*p++ = ' ';
+		p = FormatFloat(p, texCoords[i].v, precision);
+		*p++ = '\n';
+	}
+	out->resize(p - out->data());
+}
+
+/**
+ * Appends "f" lines for the given faces to out. Every vertex has its own
+ * normal and texture coordinate, so if there are any they share its index.
+ */
+static void FormatFaces(const Face* faces, size_t count, unsigned int numFaceElements, bool texCoords, bool normals,
+                        std::vector<char>* out) {
+	out->resize(count * TYPICAL_LINE_CHARS);
+	char* p = out->data();
+	for (size_t n = 0; n < count; ++n) {
+		p = ReserveLine(out, p, MAX_FACE_CHARS);
+		auto* fv = (const unsigned int*)&faces[n];
+		*p++ = 'f';
+		for (unsigned int i = 0; i < numFaceElements; ++i) {
+			*p++ = ' ';
+			char* index = p;
+			p = FormatIndex(p, (uint64_t)fv[i] + 1);
+			if (texCoords || normals) {
+				size_t length = p - index;
+				*p++ = '/';
+				if (texCoords) {
+					memcpy(p, index, length);
+					p += length;
+				}
+				if (normals) {
+					*p++ = '/';
+					memcpy(p, index, length);
+					p += length;
+				}
+			}
+		}
+		*p++ = '\n';
+	}
+	out->resize(p - out->data());
+}
+
+/**
+ * Splits count elements into chunks which are formatted in parallel, and then
+ * written out in order so the result is the same as formatting them serially.
+ */
+static void WriteChunked(FILE* file, size_t count, const std::function<void(size_t, size_t, std::vector<char>*)>& format) {
+	static constexpr size_t CHUNK_SIZE = 16384;
+	size_t numChunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+	// Only format a few chunks per thread at a time, to keep the amount of text
+	// held in memory down. With just the one thread there's nothing to batch up,
+	// which is also the case when we're already running as one of the pool's tasks.
+	ThreadPool& threadPool = GetThreadPool();
+	size_t numThreads = ThreadPool::IsInParallelFor() ? 1 : threadPool.GetNumThreads();
+	size_t numBuffers = std::min(numThreads > 1 ? numThreads * 2 : 1, std::max(numChunks, (size_t)1));
+	std::vector<std::vector<char>> buffers(numBuffers);
+	for (size_t firstChunk = 0; firstChunk < numChunks; firstChunk += buffers.size()) {
+		size_t numBatchChunks = std::min(buffers.size(), numChunks - firstChunk);
+		threadPool.ParallelFor(numBatchChunks, [&](size_t i) {
+			size_t start = (firstChunk + i) * CHUNK_SIZE;
+			format(start, std::min(CHUNK_SIZE, count - start), &buffers[i]);
+		});
+		for (size_t i = 0; i < numBatchChunks; ++i) {
+			fwrite(buffers[i].data(), 1, buffers[i].size(), file);
+		}
+	}
+}
+
+#define CloseFile(FILE) if( (FILE) != nullptr ) fclose( (FILE) ); (FILE) = nullptr
+
+/**
+ * Closes a file that's been written to, returning false if any of the writes
+ * failed, including flushing whatever was still buffered.
+ */
+static bool FinishFile(FILE* file) {
+	bool failed = ferror(file) != 0;
+	return fclose(file) == 0 && !failed;
+}
+
+/**
+ * Writes out the normals and texture coordinates from first up to count, for
+ * whichever of them the job has.
+ */
+static void WriteAttributes(FILE* file, Job* job, size_t first, size_t count) {
+	if (job->vertexNormal.present) {
+		WriteChunked(file, count, [job, first](size_t start, size_t count, std::vector<char>* out) {
+			FormatVertices(job->meshNormals.data() + first + start, count, job->precision, "vn", out);
+		});
+	}
+	if (job->vertexTexCoord.present) {
+		WriteChunked(file, count, [job, first](size_t start, size_t count, std::vector<char>* out) {
+			FormatTexCoords(job->meshTexCoords.data() + first + start, count, job->precision, out);
+		});
+	}
+}
+
+static bool IsBigEndianHost() {
+	const uint16_t v = 1;
+	uint8_t b;
+	memcpy(&b, &v, 1);
+	return b == 0;
+}
+
+static bool WriteObj(Job* job, const char* path) {
+	FILE* file = fopen(path, "w");
+	if (file == nullptr) {
+		return false;
+	}
+
+	fprintf(file, "# Generated by Bin2Obj, by Mark \"hogsy\" Sowden <hogsy@oldtimes-software.com>\n\n");
+	if (job->precision > MAX_PRECISION) {
+		job->precision = MAX_PRECISION;
+	}
+
+	WriteChunked(file, job->meshVertices.size(), [job](size_t start, size_t count, std::vector<char>* out) {
+		FormatVertices(job->meshVertices.data() + start, count, job->precision, "v", out);
+	});
+	WriteAttributes(file, job, 0, job->meshVertices.size());
+
+	unsigned int numFaceElements = job->faceQuad ? 4 : 3;
+	WriteChunked(file, job->meshFaces.size(), [job, numFaceElements](size_t start, size_t count, std::vector<char>* out) {
+		FormatFaces(job->meshFaces.data() + start, count, numFaceElements, job->vertexTexCoord.present, job->vertexNormal.present, out);
+	});
+
+	return FinishFile(file);
+}
+
+/**
+ * Writes the mesh out as a binary PLY, in the host's byte order so that the
+ * vertex and face arrays can go out as-is.
+ */
+static bool WritePly(Job* job, const char* path) {
+	static_assert(sizeof(Vertex) == sizeof(float) * 3, "Vertex is expected to be tightly packed!");
+
+	// PLY faces are a count followed by the indices, so pack them up front.
+	unsigned int numFaceElements = job->faceQuad ? 4 : 3;
+	size_t faceSize = sizeof(uint8_t) + sizeof(uint32_t) * numFaceElements;
+	std::vector<uint8_t> faceData(job->meshFaces.size() * faceSize);
+	uint8_t* p = faceData.data();
+	for (const auto& face : job->meshFaces) {
+		*p = (uint8_t)numFaceElements;
+		memcpy(p + 1, &face, sizeof(uint32_t) * numFaceElements);
+		p += faceSize;
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr) {
+		return false;
+	}
+
+	fprintf(file,
+	        "ply\n"
+	        "format %s 1.0\n"
+	        "comment Generated by Bin2Obj, by Mark \"hogsy\" Sowden <hogsy@oldtimes-software.com>\n"
+	        "element vertex %zu\n"
+	        "property float x\n"
+	        "property float y\n"
+	        "property float z\n"
+	        "element face %zu\n"
+	        "property list uchar uint vertex_indices\n"
+	        "end_header\n",
+	        IsBigEndianHost() ? "binary_big_endian" : "binary_little_endian",
+	        job->meshVertices.size(), faceData.size() / faceSize);
+
+	fwrite(job->meshVertices.data(), sizeof(Vertex), job->meshVertices.size(), file);
+	fwrite(faceData.data(), 1, faceData.size(), file);
+
+	return FinishFile(file);
+}
+
+static void ComputeBounds(const Vertex* vertices, size_t count, Vertex* mins, Vertex* maxs) {
+	if (count == 0) {
+		*mins = *maxs = Vertex();
+		return;
+	}
+
+	*mins = *maxs = vertices[0];
+	for (size_t i = 1; i < count; ++i) {
+		mins->x = std::min(mins->x, vertices[i].x);
+		mins->y = std::min(mins->y, vertices[i].y);
+		mins->z = std::min(mins->z, vertices[i].z);
+		maxs->x = std::max(maxs->x, vertices[i].x);
+		maxs->y = std::max(maxs->y, vertices[i].y);
+		maxs->z = std::max(maxs->z, vertices[i].z);
+	}
+}
+
+static void ComputeBounds(const VertexArrays& vertices, Vertex* mins, Vertex* maxs) {
+	if (vertices.count == 0) {
+		*mins = *maxs = Vertex();
+		return;
+	}
+
+	const float* components[3] = { vertices.x, vertices.y, vertices.z };
+	float* minComponents[3] = { &mins->x, &mins->y, &mins->z };
+	float* maxComponents[3] = { &maxs->x, &maxs->y, &maxs->z };
+	for (unsigned int j = 0; j < 3; ++j) {
+		const float* c = components[j];
+		float lo = c[0], hi = c[0];
+		size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+		__m128 lo4 = _mm_set1_ps(lo), hi4 = lo4;
+		for (; i + 4 <= vertices.count; i += 4) {
+			__m128 v = _mm_load_ps(c + i);
+			lo4 = _mm_min_ps(lo4, v);
+			hi4 = _mm_max_ps(hi4, v);
+		}
+		alignas(16) float lanes[8];
+		_mm_store_ps(lanes, lo4);
+		_mm_store_ps(lanes + 4, hi4);
+		for (unsigned int lane = 0; lane < 4; ++lane) {
+			lo = std::min(lo, lanes[lane]);
+			hi = std::max(hi, lanes[lane + 4]);
+		}
+#endif
+		for (; i < vertices.count; ++i) {
+			lo = std::min(lo, c[i]);
+			hi = std::max(hi, c[i]);
+		}
+		*minComponents[j] = lo;
+		*maxComponents[j] = hi;
+	}
+}
+
+/**
+ * Appends a JSON array of the vertex components, as glTF wants for accessor bounds.
+ */
+static void AppendJsonVertex(std::string* json, const Vertex& v) {
+	char buf[3 * (MAX_FLOAT_CHARS + MAX_PRECISION) + 8];
+	char* p = buf;
+	*p++ = '[';
+	const float* components = &v.x;
+	for (unsigned int i = 0; i < 3; ++i) {
+		// JSON has no way to represent these.
+		float c = std::isfinite(components[i]) ? components[i] : std::copysign(FLT_MAX, components[i]);
+		if (i > 0) {
+			*p++ = ',';
+		}
+		p = FormatFloat(p, c, -1);
+	}
+	*p++ = ']';
+	json->append(buf, p - buf);
+}
+
+/**
+ * Writes the mesh out as a binary glTF. If sourceVertices is provided, the
+ * position buffer view is taken directly from those bytes, using the source
+ * pitch as the stride, rather than our decoded copy. Likewise, the bounds are
+ * only worked out here if they weren't already known.
+ */
+static bool WriteGlb(Job* job, const char* path, const uint8_t* sourceVertices, size_t sourcePitch, const Vertex* bounds) {
+	// glTF has no quads, so split them into a pair of triangles.
+	std::vector<uint32_t> indices;
+	indices.reserve(job->meshFaces.size() * (job->faceQuad ? 6 : 3));
+	for (const auto& face : job->meshFaces) {
+		indices.insert(indices.end(), { face.x, face.y, face.z });
+		if (job->faceQuad) {
+			indices.insert(indices.end(), { face.x, face.z, face.w });
+		}
+	}
+
+	size_t numVertices = job->meshVertices.size();
+	const uint8_t* positions = (const uint8_t*)job->meshVertices.data();
+	size_t positionStride = sizeof(Vertex);
+	if (sourceVertices != nullptr) {
+		positions = sourceVertices;
+		positionStride = sourcePitch;
+	}
+	size_t positionBytes = numVertices > 0 ? (numVertices - 1) * positionStride + sizeof(Vertex) : 0;
+	size_t positionPadding = (4 - positionBytes % 4) % 4;
+	size_t indexOffset = positionBytes + positionPadding;
+	size_t indexBytes = indices.size() * sizeof(uint32_t);
+	size_t binBytes = indexOffset + indexBytes;
+
+	Vertex mins, maxs;
+	if (bounds != nullptr) {
+		mins = bounds[0];
+		maxs = bounds[1];
+	} else {
+		ComputeBounds(job->meshVertices.data(), numVertices, &mins, &maxs);
+	}
+
+	std::string json = "{\"asset\":{\"version\":\"2.0\",\"generator\":\"Bin2Obj\"},";
+	if (numVertices == 0) {
+		// glTF doesn't allow empty buffers or accessors, so there's nothing but an empty scene.
+		binBytes = 0;
+		json += "\"scenes\":[{}],\"scene\":0}";
+	} else {
+		json += "\"buffers\":[{\"byteLength\":" + std::to_string(binBytes) + "}],";
+		json += "\"bufferViews\":[{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" + std::to_string(positionBytes);
+		if (positionStride != sizeof(Vertex)) {
+			json += ",\"byteStride\":" + std::to_string(positionStride);
+		}
+		json += ",\"target\":34962}";
+		if (!indices.empty()) {
+			json += ",{\"buffer\":0,\"byteOffset\":" + std::to_string(indexOffset) +
+			        ",\"byteLength\":" + std::to_string(indexBytes) + ",\"target\":34963}";
+		}
+		json += "],\"accessors\":[{\"bufferView\":0,\"componentType\":5126,\"count\":" + std::to_string(numVertices) +
+		        ",\"type\":\"VEC3\",\"min\":";
+		AppendJsonVertex(&json, mins);
+		json += ",\"max\":";
+		AppendJsonVertex(&json, maxs);
+		json += "}";
+		if (!indices.empty()) {
+			json += ",{\"bufferView\":1,\"componentType\":5125,\"count\":" + std::to_string(indices.size()) +
+			        ",\"type\":\"SCALAR\"}";
+		}
+		json += "],\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0}";
+		// Without any faces, just provide the points.
+		json += indices.empty() ? ",\"mode\":0}]}]," : ",\"indices\":1,\"mode\":4}]}],";
+		json += "\"nodes\":[{\"mesh\":0}],\"scenes\":[{\"nodes\":[0]}],\"scene\":0}";
+	}
+	json.append((4 - json.size() % 4) % 4, ' ');
+
+	// Lengths in a GLB are only 32-bit.
+	uint64_t glbBytes = 12 + 8 + (uint64_t)json.size() + (binBytes > 0 ? 8 + (uint64_t)binBytes : 0);
+	if (glbBytes > UINT32_MAX) {
+		Print("Mesh is too large for a glb, which is limited to 4 GiB!\n");
+		return false;
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr) {
+		return false;
+	}
+
+	// Everything in a GLB is little-endian.
+	auto WriteU32 = [file](uint32_t v) {
+		uint8_t bytes[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) };
+		fwrite(bytes, 1, sizeof(bytes), file);
+	};
+
+	WriteU32(0x46546C67);  // glTF
+	WriteU32(2);
+	WriteU32((uint32_t)glbBytes);
+
+	WriteU32((uint32_t)json.size());
+	WriteU32(0x4E4F534A);  // JSON
+	fwrite(json.data(), 1, json.size(), file);
+
+	if (binBytes > 0) {
+		WriteU32((uint32_t)binBytes);
+		WriteU32(0x004E4942);  // BIN
+		fwrite(positions, 1, positionBytes, file);
+		static const uint8_t padding[4] = {};
+		fwrite(padding, 1, positionPadding, file);
+		if (!indices.empty()) {
+			fwrite(indices.data(), sizeof(uint32_t), indices.size(), file);
+		}
+	}
+
+	return FinishFile(file);
+}
+
+/**
+ * Tally of the out of bound indices found by ValidateFaceIndices.
+ */
+struct FaceBoundsReport {
+	size_t numFaces{ 0 };
+	size_t numIndices{ 0 };
+	unsigned int largestIndex{ 0 };
+};
+
+/**
+ * Checks every face index against the number of vertices. Faces with any
+ * index out of bounds either have those indices set to 0, or are dropped.
+ */
+static void ValidateFaceIndices(std::vector<Face>* faces, unsigned int numFaceElements, size_t numVertices,
+                                bool dropFaces, FaceBoundsReport* report) {
+	Face* f = faces->data();
+	size_t count = faces->size();
+	size_t numKept = 0;
+	unsigned int limit = (unsigned int)std::min<size_t>(numVertices, UINT32_MAX);
+	int elementMask = (1 << numFaceElements) - 1;
+#if defined( BIN2OBJ_SSE2 )
+	// There's no unsigned compare in SSE2, so flip the sign bits and compare signed.
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i biasedLimit = _mm_xor_si128(_mm_set1_epi32((int)limit), bias);
+#endif
+	for (size_t i = 0; i < count; ++i) {
+		auto* fv = (unsigned int*)&f[i];
+#if defined( BIN2OBJ_SSE2 )
+		__m128i v = _mm_loadu_si128((const __m128i*)fv);
+		__m128i inBounds = _mm_cmplt_epi32(_mm_xor_si128(v, bias), biasedLimit);
+		int outOfBounds = ~_mm_movemask_ps(_mm_castsi128_ps(inBounds)) & elementMask;
+#else
+		int outOfBounds = 0;
+		for (unsigned int j = 0; j < numFaceElements; ++j) {
+			outOfBounds |= (fv[j] >= limit) << j;
+		}
+#endif
+		if (outOfBounds != 0) {
+			report->numFaces++;
+			for (unsigned int j = 0; j < numFaceElements; ++j) {
+				if ((outOfBounds >> j) & 1) {
+					report->numIndices++;
+					report->largestIndex = std::max(report->largestIndex, fv[j]);
+					fv[j] = 0;
+				}
+			}
+			if (dropFaces) {
+				continue;
+			}
+		}
+		f[numKept++] = f[i];
+	}
+	faces->resize(numKept);
+}
+
+/**
+ * Key identifying where a vertex lands for welding; either the exact bits of
+ * each component, or the grid cell it falls in.
+ */
+struct WeldKey {
+	uint64_t c[3];
+
+	bool operator==(const WeldKey& other) const { return c[0] == other.c[0] && c[1] == other.c[1] && c[2] == other.c[2]; }
+};
+
+static inline WeldKey MakeWeldKey(const Vertex& v, float tolerance) {
+	// Cells this far out either way can't be stored in the key, which is also
+	// where components that aren't finite end up, so those fall back on their
+	// exact bits. Offset by the limit, those keys sit between the positive and
+	// negative cells and can't clash with either.
+	static constexpr double MAX_CELL = 4611686018427387904.0;  // 2^62
+
+	WeldKey key;
+	const float* components = &v.x;
+	for (unsigned int i = 0; i < 3; ++i) {
+		if (tolerance > 0.0f) {
+			double cell = std::floor((double)components[i] / tolerance);
+			if (std::fabs(cell) < MAX_CELL) {
+				key.c[i] = (uint64_t)(int64_t)cell;
+				continue;
+			}
+		}
+
+		// Adding zero folds -0 into +0, so the two weld together.
+		float c = components[i] + 0.0f;
+		uint32_t bits;
+		memcpy(&bits, &c, sizeof(bits));
+		key.c[i] = tolerance > 0.0f ? (uint64_t)MAX_CELL + bits : bits;
+	}
+	return key;
+}
+
+static inline uint64_t HashWeldKey(const WeldKey& key) {
+	uint64_t h = key.c[0] * 0x9E3779B97F4A7C15ull;
+	h = (h ^ (h >> 29) ^ key.c[1]) * 0xBF58476D1CE4E5B9ull;
+	h = (h ^ (h >> 32) ^ key.c[2]) * 0x94D049BB133111EBull;
+	return h ^ (h >> 31);
+}
+
+/**
+ * Merges together vertices with the same position, or falling within the same
+ * cell of a grid when a tolerance is given, and remaps the faces to match.
+ * Uses a flat open-addressed table rather than a node-based map, since it can
+ * be looking at tens of millions of vertices. Returns the number removed.
+ */
+static size_t WeldVertices(std::vector<Vertex>* vertices, std::vector<Face>* faces, unsigned int numFaceElements, float tolerance) {
+	size_t numVertices = vertices->size();
+	if (numVertices == 0) {
+		return 0;
+	}
+
+	// Keep the table at most half full so probes stay short.
+	size_t capacity = 16;
+	while (capacity < numVertices * 2) {
+		capacity <<= 1;
+	}
+	size_t mask = capacity - 1;
+
+	// Slots hold one past the index of the unique vertex, so zero is empty.
+	std::vector<uint32_t> slots(capacity, 0);
+	std::vector<uint32_t> remap(numVertices);
+	Vertex* v = vertices->data();
+	size_t numUnique = 0;
+	for (size_t i = 0; i < numVertices; ++i) {
+		WeldKey key = MakeWeldKey(v[i], tolerance);
+		size_t slot = HashWeldKey(key) & mask;
+		for (;;) {
+			uint32_t entry = slots[slot];
+			if (entry == 0) {
+				slots[slot] = (uint32_t)(numUnique + 1);
+				v[numUnique] = v[i];
+				remap[i] = (uint32_t)numUnique++;
+				break;
+			}
+			if (MakeWeldKey(v[entry - 1], tolerance) == key) {
+				remap[i] = entry - 1;
+				break;
+			}
+			slot = (slot + 1) & mask;
+		}
+	}
+	vertices->resize(numUnique);
+
+	for (auto& face : *faces) {
+		auto* fv = (unsigned int*)&face;
+		for (unsigned int i = 0; i < numFaceElements; ++i) {
+			fv[i] = remap[fv[i]];
+		}
+	}
+
+	return numVertices - numUnique;
+}
+
+/**
+ * One way of reading a run of vertices out of the data.
+ */
+struct VertexReading {
+	size_t offset{ 0 };
+	size_t pitch{ 0 };
+	size_t count{ 0 };
+	Job::VertexType type{ Job::VertexType::F32 };
+};
+
+/**
+ * A run of data the scanner thinks could be a vertex array.
+ */
+struct VertexCandidate {
+	size_t offset{ 0 };
+	size_t pitch{ 0 };
+	size_t count{ 0 };
+	Job::VertexType type{ Job::VertexType::F32 };
+	float score{ 0.0f };
+	Vertex mins, maxs;
+
+	// Lower scoring readings of much the same bytes, with another pitch or
+	// starting at another attribute, in case this one is the wrong one.
+	static constexpr unsigned int MAX_ALTERNATIVES = 6;
+	VertexReading alternatives[MAX_ALTERNATIVES];
+	unsigned int numAlternatives{ 0 };
+};
+
+// Anything smaller than this, other than zero, is unlikely to be a coordinate.
+// Random bytes mostly read as floats with huge or tiny exponents, so this
+// also keeps a lot of junk out.
+static constexpr float SCAN_MIN_MAGNITUDE = 1e-10f;
+static constexpr size_t SCAN_MAX_PITCH = 64;
+static constexpr size_t SCAN_REGION_SIZE = 16 * 1024 * 1024;
+
+static inline bool IsPlausibleCoordinate(float v, float bound) {
+	float a = std::fabs(v);
+	return a == 0.0f || (a >= SCAN_MIN_MAGNITUDE && a <= bound);
+}
+
+/**
+ * Flags each 4-byte word that reads as a plausible float32 coordinate.
+ */
+static void ClassifyFloats(const uint8_t* src, size_t numWords, float bound, uint8_t* out) {
+	size_t i = 0;
+#if defined( BIN2OBJ_SSE2 )
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 lower = _mm_set1_ps(SCAN_MIN_MAGNITUDE);
+	const __m128 upper = _mm_set1_ps(bound);
+	const __m128 zero = _mm_setzero_ps();
+	for (; i + 4 <= numWords; i += 4) {
+		__m128 a = _mm_and_ps(_mm_loadu_ps((const float*)(src + i * 4)), absMask);
+		__m128 inRange = _mm_and_ps(_mm_cmpge_ps(a, lower), _mm_cmple_ps(a, upper));
+		int mask = _mm_movemask_ps(_mm_or_ps(inRange, _mm_cmpeq_ps(a, zero)));
+		out[i + 0] = (uint8_t)(mask & 1);
+		out[i + 1] = (uint8_t)((mask >> 1) & 1);
+		out[i + 2] = (uint8_t)((mask >> 2) & 1);
+		out[i + 3] = (uint8_t)((mask >> 3) & 1);
+	}
+#endif
+	for (; i < numWords; ++i) {
+		float v;
+		memcpy(&v, src + i * 4, sizeof(float));
+		out[i] = IsPlausibleCoordinate(v, bound);
+	}
+}
+
+/**
+ * Returns the value the given fraction of the way through values, which are
+ * left partially sorted.
+ */
+static double GetPercentile(std::vector<double>* values, double fraction) {
+	size_t k = (size_t)(fraction * (double)(values->size() - 1));
+	std::nth_element(values->begin(), values->begin() + k, values->end());
+	return (*values)[k];
+}
+
+static inline double GetStepLength(const Vertex& a, const Vertex& b) {
+	double sx = b.x - a.x;
+	double sy = b.y - a.y;
+	double sz = b.z - a.z;
+	return std::sqrt(sx * sx + sy * sy + sz * sz);
+}
+
+/**
+ * Scores a candidate by decoding it and looking at how coherent it is, on the
+ * basis that neighbouring vertices in a real mesh tend to be close together.
+ * Junk either side of a real array can easily pass as a vertex or two, so any
+ * vertices at the ends of the run that stand out from the rest are trimmed
+ * off first, and the steps are measured against the extent of the bulk of the
+ * vertices rather than the outright bounds. Long runs are only judged on an
+ * even spread of windows of neighbouring vertices, so scoring one never needs
+ * to hold more than a fixed number of them.
+ */
+static void ScoreVertexCandidate(const uint8_t* data, size_t minCount, VertexCandidate* candidate) {
+	auto Decode = [&](size_t first, size_t count, Vertex* out) {
+		const uint8_t* src = data + candidate->offset + first * candidate->pitch;
+		switch (candidate->type) {
+			default:
+				DecodeVerticesF32(src, count, candidate->pitch, 1.0f, out);
+				break;
+			case Job::VertexType::I16:
+				DecodeVerticesInt<int16_t>(src, count, candidate->pitch, 1.0f, -FLT_MAX, out);
+				break;
+		}
+	};
+
+	static constexpr size_t MAX_WINDOWS = 16;
+	static constexpr size_t MAX_WINDOW_SIZE = 4096;
+	size_t numWindows = 1;
+	size_t windowSize = candidate->count;
+	if (candidate->count > MAX_WINDOWS * MAX_WINDOW_SIZE) {
+		numWindows = MAX_WINDOWS;
+		windowSize = MAX_WINDOW_SIZE;
+	}
+	std::vector<Vertex> vertices(numWindows * windowSize);
+	for (size_t w = 0; w < numWindows; ++w) {
+		size_t first = numWindows > 1 ? w * (candidate->count - windowSize) / (numWindows - 1) : 0;
+		Decode(first, windowSize, vertices.data() + w * windowSize);
+	}
+
+	// There's no step between the last vertex of one window and the first of the next.
+	std::vector<double> steps(vertices.size() - 1);
+	for (size_t i = 0; i < steps.size(); ++i) {
+		steps[i] = (i + 1) % windowSize != 0 ? GetStepLength(vertices[i], vertices[i + 1]) : -1.0;
+	}
+
+	// Extent of the middle 90% of the vertices on each axis, and the typical
+	// step. Long runs only have these estimated from an even spread of samples.
+	static constexpr size_t MAX_SAMPLES = 4096;
+	size_t sampleStride = std::max<size_t>(1, steps.size() / MAX_SAMPLES);
+	double lower[3], upper[3];
+	std::vector<double> values;
+	values.reserve(MAX_SAMPLES + 1);
+	for (unsigned int axis = 0; axis < 3; ++axis) {
+		values.clear();
+		for (size_t i = 0; i < vertices.size(); i += sampleStride) {
+			values.push_back(((const float*)&vertices[i])[axis]);
+		}
+		lower[axis] = GetPercentile(&values, 0.05);
+		upper[axis] = GetPercentile(&values, 0.95);
+	}
+	values.clear();
+	for (size_t i = 0; i < steps.size(); i += sampleStride) {
+		if (steps[i] >= 0.0) {
+			values.push_back(steps[i]);
+		}
+	}
+	double medianStep = GetPercentile(&values, 0.5);
+
+	// Anything well outside the bulk of the vertices, or a far bigger step away
+	// from its neighbour than usual, is most likely junk. Only the first and
+	// last windows are ever trimmed.
+	auto IsOutlier = [&](size_t i, double step) {
+		const auto* c = (const float*)&vertices[i];
+		for (unsigned int axis = 0; axis < 3; ++axis) {
+			double margin = upper[axis] - lower[axis];
+			if (c[axis] < lower[axis] - margin || c[axis] > upper[axis] + margin) {
+				return true;
+			}
+		}
+		return medianStep > 0.0 && step > medianStep * 16.0;
+	};
+	size_t first = 0;
+	size_t last = vertices.size();
+	while (last - first > 2 && first + 2 < windowSize && IsOutlier(first, steps[first])) {
+		first++;
+	}
+	while (last - first > 2 && last > vertices.size() - windowSize + 2 && IsOutlier(last - 1, steps[last - 2])) {
+		last--;
+	}
+	candidate->offset += first * candidate->pitch;
+	candidate->count -= first + (vertices.size() - last);
+	if (candidate->count < minCount) {
+		candidate->score = 0.0f;
+		return;
+	}
+
+	ComputeBounds(vertices.data() + first, last - first, &candidate->mins, &candidate->maxs);
+	double dx = candidate->maxs.x - candidate->mins.x;
+	double dy = candidate->maxs.y - candidate->mins.y;
+	double dz = candidate->maxs.z - candidate->mins.z;
+	double extent = std::sqrt((upper[0] - lower[0]) * (upper[0] - lower[0]) + (upper[1] - lower[1]) * (upper[1] - lower[1]) +
+	                          (upper[2] - lower[2]) * (upper[2] - lower[2]));
+	if (extent <= 0.0) {
+		extent = std::sqrt(dx * dx + dy * dy + dz * dz);
+		if (extent <= 0.0) {
+			candidate->score = 0.0f;
+			return;
+		}
+	}
+
+	double totalStep = 0.0;
+	size_t numSteps = 0;
+	size_t numDistinct = 0;
+	for (size_t i = first; i + 1 < last; ++i) {
+		if (steps[i] >= 0.0) {
+			totalStep += steps[i];
+			numSteps++;
+			numDistinct += steps[i] > 0.0;
+		}
+	}
+
+	// Score on the bytes covered rather than the vertex count, so that reading a
+	// real array with half its pitch doesn't win out by doubling its count.
+	double coherence = 1.0 - std::min(1.0, (totalStep / (double)numSteps) / extent);
+	double distinct = (double)numDistinct / (double)numSteps;
+	// Positions are rarely perfectly flat, but a misaligned read into padding often is.
+	double flatness = (double)((dx > 0.0) + (dy > 0.0) + (dz > 0.0)) / 3.0;
+	double coverage = (double)(candidate->count * candidate->pitch);
+	candidate->score = (float)(coverage * std::pow(coherence, 4.0) * distinct * flatness * flatness);
+
+	// The windows only give rough bounds, so anything worth listing has the
+	// rest of its vertices streamed through a window at a time.
+	if (numWindows > 1 && candidate->score > 0.0f) {
+		for (size_t i = 0; i < candidate->count; i += windowSize) {
+			size_t count = std::min(windowSize, candidate->count - i);
+			Vertex mins, maxs;
+			Decode(i, count, vertices.data());
+			ComputeBounds(vertices.data(), count, &mins, &maxs);
+			candidate->mins.x = std::min(candidate->mins.x, mins.x);
+			candidate->mins.y = std::min(candidate->mins.y, mins.y);
+			candidate->mins.z = std::min(candidate->mins.z, mins.z);
+			candidate->maxs.x = std::max(candidate->maxs.x, maxs.x);
+			candidate->maxs.y = std::max(candidate->maxs.y, maxs.y);
+			candidate->maxs.z = std::max(candidate->maxs.z, maxs.z);
+		}
+	}
+}
+
+/**
+ * Walks every residue of the given pitch within the region, reporting runs of
+ * valid, coherent elements that start inside it. Runs are followed past the
+ * end of the region, and runs that began in an earlier region are left to it.
+ */
+template<typename IsValid, typename IsCoherent, typename OnRun>
+static void WalkRuns(size_t regionStart, size_t regionEnd, size_t dataSize,
+                     size_t elementSize, size_t pitch, size_t alignment, size_t minCount,
+                     const IsValid& isValid, const IsCoherent& isCoherent, const OnRun& onRun) {
+	for (size_t phase = 0; phase < pitch; phase += alignment) {
+		size_t pos = regionStart + phase;
+		if (pos + elementSize > dataSize) {
+			break;
+		}
+
+		size_t runStart = pos;
+		size_t runLength = 0;
+		bool inherited = pos >= pitch && isValid(pos) && isValid(pos - pitch) && isCoherent(pos - pitch, pos);
+		if (inherited) {
+			runLength = 1;
+			pos += pitch;
+		}
+
+		for (;; pos += pitch) {
+			bool valid = pos + elementSize <= dataSize && isValid(pos);
+			if (valid && runLength > 0 && isCoherent(pos - pitch, pos)) {
+				runLength++;
+				continue;
+			}
+
+			if (runLength >= minCount && !inherited) {
+				onRun(runStart, runLength);
+			}
+			inherited = false;
+			runLength = 0;
+
+			if (pos >= regionEnd || !valid) {
+				if (pos >= regionEnd || pos + elementSize > dataSize) {
+					break;
+				}
+				continue;
+			}
+
+			runStart = pos;
+			runLength = 1;
+		}
+	}
+}
+
+static void AddVertexCandidate(size_t offset, size_t pitch, size_t count, Job::VertexType type,
+                               std::vector<VertexCandidate>* candidates) {
+	VertexCandidate candidate;
+	candidate.offset = offset;
+	candidate.pitch = pitch;
+	candidate.count = count;
+	candidate.type = type;
+	candidates->push_back(candidate);
+}
+
+/**
+ * Looks for vertex arrays within the given data, returning the best
+ * candidates with the highest scoring first.
+ */
+static std::vector<VertexCandidate> ScanForVertices(const uint8_t* data, size_t size, size_t minCount, float bound) {
+	if (minCount < 2) {
+		minCount = 2;
+	}
+
+	size_t numRegions = (size + SCAN_REGION_SIZE - 1) / SCAN_REGION_SIZE;
+	std::vector<std::vector<VertexCandidate>> regionCandidates(numRegions);
+	GetThreadPool().ParallelFor(numRegions, [&](size_t region) {
+		size_t regionStart = region * SCAN_REGION_SIZE;
+		size_t regionEnd = std::min(size, regionStart + SCAN_REGION_SIZE);
+		std::vector<VertexCandidate>* candidates = &regionCandidates[region];
+
+		// Classify the region up front, plus a little extra for runs that spill over.
+		size_t classifiedEnd = std::min(size, regionEnd + SCAN_MAX_PITCH * 2);
+		std::vector<uint8_t> plausible((classifiedEnd - regionStart) / 4);
+		ClassifyFloats(data + regionStart, plausible.size(), bound, plausible.data());
+		auto IsPlausibleWord = [&](size_t pos) {
+			size_t word = (pos - regionStart) / 4;
+			if (word < plausible.size()) {
+				return plausible[word] != 0;
+			}
+			float v;
+			memcpy(&v, data + pos, sizeof(float));
+			return IsPlausibleCoordinate(v, bound);
+		};
+
+		// As with int16 below, all-zero triples are left out, as otherwise any
+		// zero-filled span would read as one long, perfectly coherent run.
+		auto IsValidF32 = [&](size_t pos) {
+			if (!IsPlausibleWord(pos) || !IsPlausibleWord(pos + 4) || !IsPlausibleWord(pos + 8)) {
+				return false;
+			}
+			uint32_t c[3];
+			memcpy(c, data + pos, sizeof(c));
+			return ((c[0] | c[1] | c[2]) & 0x7FFFFFFF) != 0;
+		};
+		// Much like int16 below, no component should jump by more than a sixteenth of the range.
+		const float maxStep = bound / 16.0f;
+		auto IsCoherentF32 = [&](size_t a, size_t b) {
+			float ca[3], cb[3];
+			memcpy(ca, data + a, sizeof(ca));
+			memcpy(cb, data + b, sizeof(cb));
+			return std::fabs(ca[0] - cb[0]) <= maxStep && std::fabs(ca[1] - cb[1]) <= maxStep && std::fabs(ca[2] - cb[2]) <= maxStep;
+		};
+		for (size_t pitch = 12; pitch <= SCAN_MAX_PITCH; pitch += 4) {
+			WalkRuns(regionStart, regionEnd, size, 12, pitch, 4, minCount, IsValidF32, IsCoherentF32,
+			         [&](size_t start, size_t length) {
+				         AddVertexCandidate(start, pitch, length, Job::VertexType::F32, candidates);
+			         });
+		}
+
+		// Any int16 triple is a valid vertex, so lean on there being no large jumps instead.
+		auto IsValidI16 = [&](size_t pos) {
+			int16_t c[3];
+			memcpy(c, data + pos, sizeof(c));
+			return c[0] != 0 || c[1] != 0 || c[2] != 0;
+		};
+		auto IsCoherentI16 = [&](size_t a, size_t b) {
+			int16_t ca[3], cb[3];
+			memcpy(ca, data + a, sizeof(ca));
+			memcpy(cb, data + b, sizeof(cb));
+			return std::abs(ca[0] - cb[0]) <= 4096 && std::abs(ca[1] - cb[1]) <= 4096 && std::abs(ca[2] - cb[2]) <= 4096;
+		};
+		for (size_t pitch = 6; pitch <= SCAN_MAX_PITCH / 2; pitch += 2) {
+			WalkRuns(regionStart, regionEnd, size, 6, pitch, 2, minCount, IsValidI16, IsCoherentI16,
+			         [&](size_t start, size_t length) {
+				         AddVertexCandidate(start, pitch, length, Job::VertexType::I16, candidates);
+			         });
+		}
+
+		for (auto& candidate : *candidates) {
+			ScoreVertexCandidate(data, minCount, &candidate);
+		}
+	});
+
+	std::vector<VertexCandidate> candidates;
+	for (const auto& region : regionCandidates) {
+		candidates.insert(candidates.end(), region.begin(), region.end());
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const VertexCandidate& a, const VertexCandidate& b) {
+		return a.score > b.score;
+	});
+
+	// Misreading an array with the wrong pitch produces plenty of overlapping
+	// runs, so only keep the best of anything covering much the same bytes.
+	// The best isn't always the right one though, particularly when reading it
+	// from another attribute scores just as well, so other distinct readings of
+	// the same bytes are kept as alternatives.
+	std::vector<VertexCandidate> best;
+	for (const auto& candidate : candidates) {
+		if (candidate.score <= 0.0f) {
+			break;
+		}
+
+		size_t end = candidate.offset + (candidate.count - 1) * candidate.pitch + 12;
+		bool overlaps = false;
+		for (auto& other : best) {
+			size_t otherEnd = other.offset + (other.count - 1) * other.pitch + 12;
+			size_t overlap = std::min(end, otherEnd) > std::max(candidate.offset, other.offset)
+			                        ? std::min(end, otherEnd) - std::max(candidate.offset, other.offset) : 0;
+			if (overlap * 2 <= end - candidate.offset) {
+				continue;
+			}
+
+			overlaps = true;
+			auto IsSameReading = [&](size_t offset, size_t pitch, Job::VertexType type) {
+				return pitch == candidate.pitch && type == candidate.type && offset % pitch == candidate.offset % pitch;
+			};
+			bool seen = IsSameReading(other.offset, other.pitch, other.type);
+			for (unsigned int i = 0; i < other.numAlternatives && !seen; ++i) {
+				seen = IsSameReading(other.alternatives[i].offset, other.alternatives[i].pitch, other.alternatives[i].type);
+			}
+			if (!seen && other.numAlternatives < VertexCandidate::MAX_ALTERNATIVES) {
+				other.alternatives[other.numAlternatives++] = { candidate.offset, candidate.pitch, candidate.count, candidate.type };
+			}
+			break;
+		}
+		if (!overlaps) {
+			best.push_back(candidate);
+		}
+	}
+
+	return best;
+}
+
+/**
+ * A run of data the scanner thinks could be a list of faces.
+ */
+struct IndexCandidate {
+	size_t offset{ 0 };
+	size_t numFaces{ 0 };
+	Job::FaceType type{ Job::FaceType::I16 };
+	bool quad{ false };
+	float score{ 0.0f };
+	float degenerate{ 0.0f };
+	uint32_t minIndex{ 0 }, maxIndex{ 0 };
+};
+
+/**
+ * Flags each index below the bound.
+ */
+static void ClassifyIndices(const uint8_t* src, size_t numIndices, Job::FaceType type, uint32_t bound, uint8_t* out) {
+	size_t i = 0;
+	if (type == Job::FaceType::I16) {
+		// Capping at 0xFFFF also keeps restart markers out.
+		uint16_t bound16 = (uint16_t)std::min<uint32_t>(bound, 0xFFFF);
+#if defined( BIN2OBJ_SSE2 )
+		// There's no unsigned compare in SSE2, so flip the sign bits and compare signed.
+		const __m128i bias = _mm_set1_epi16((short)0x8000);
+		const __m128i limit = _mm_xor_si128(_mm_set1_epi16((short)bound16), bias);
+		const __m128i one = _mm_set1_epi8(1);
+		for (; i + 8 <= numIndices; i += 8) {
+			__m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i * 2)), bias);
+			__m128i below = _mm_packs_epi16(_mm_cmplt_epi16(v, limit), _mm_setzero_si128());
+			_mm_storel_epi64((__m128i*)(out + i), _mm_and_si128(below, one));
+		}
+#endif
+		for (; i < numIndices; ++i) {
+			uint16_t v;
+			memcpy(&v, src + i * 2, sizeof(v));
+			out[i] = v < bound16;
+		}
+		return;
+	}
+
+#if defined( BIN2OBJ_SSE2 )
+	const __m128i bias = _mm_set1_epi32((int)0x80000000);
+	const __m128i limit = _mm_xor_si128(_mm_set1_epi32((int)bound), bias);
+	for (; i + 4 <= numIndices; i += 4) {
+		__m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(src + i * 4)), bias);
+		int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(v, limit)));
+		out[i + 0] = (uint8_t)(mask & 1);
+		out[i + 1] = (uint8_t)((mask >> 1) & 1);
+		out[i + 2] = (uint8_t)((mask >> 2) & 1);
+		out[i + 3] = (uint8_t)((mask >> 3) & 1);
+	}
+#endif
+	for (; i < numIndices; ++i) {
+		uint32_t v;
+		memcpy(&v, src + i * 4, sizeof(v));
+		out[i] = v < bound;
+	}
+}
+
+/**
+ * Works out whether a run of indices reads best as triangles or quads, and
+ * where the first face begins, based on how few faces are degenerate and how
+ * close together the indices within each face are.
+ */
+static bool ScoreIndexCandidate(const uint8_t* data, size_t offset, size_t numIndices, Job::FaceType type,
+                                IndexCandidate* best) {
+	unsigned int indexSize = type == Job::FaceType::I16 ? 2 : 4;
+	auto ReadIndex = [&](size_t i) -> uint32_t {
+		if (type == Job::FaceType::I16) {
+			uint16_t v;
+			memcpy(&v, data + offset + i * 2, sizeof(v));
+			return v;
+		}
+		uint32_t v;
+		memcpy(&v, data + offset + i * 4, sizeof(v));
+		return v;
+	};
+
+	bool found = false;
+	for (unsigned int numFaceElements = 3; numFaceElements <= 4; ++numFaceElements) {
+		for (unsigned int phase = 0; phase < numFaceElements; ++phase) {
+			size_t numFaces = (numIndices - phase) / numFaceElements;
+			if (numFaces < 2) {
+				continue;
+			}
+
+			size_t numDegenerate = 0;
+			double totalSpan = 0.0;
+			uint32_t minIndex = UINT32_MAX, maxIndex = 0;
+			for (size_t f = 0; f < numFaces; ++f) {
+				Face face;
+				auto* fv = (unsigned int*)&face;
+				uint32_t faceMin = UINT32_MAX, faceMax = 0;
+				for (unsigned int e = 0; e < numFaceElements; ++e) {
+					fv[e] = ReadIndex(phase + f * numFaceElements + e);
+					faceMin = std::min(faceMin, fv[e]);
+					faceMax = std::max(faceMax, fv[e]);
+				}
+				numDegenerate += IsDegenerateFace(face, numFaceElements);
+				totalSpan += faceMax - faceMin;
+				minIndex = std::min(minIndex, faceMin);
+				maxIndex = std::max(maxIndex, faceMax);
+			}
+
+			double degenerate = (double)numDegenerate / (double)numFaces;
+			double range = (double)(maxIndex - minIndex) + 1.0;
+			double locality = 1.0 - std::min(1.0, (totalSpan / (double)numFaces) / range);
+			double coverage = (double)(numFaces * numFaceElements * indexSize);
+			float score = (float)(coverage * std::pow(1.0 - degenerate, 2.0) * std::pow(locality, 4.0));
+			if (!found || score > best->score) {
+				best->offset = offset + phase * indexSize;
+				best->numFaces = numFaces;
+				best->type = type;
+				best->quad = numFaceElements == 4;
+				best->score = score;
+				best->degenerate = (float)degenerate;
+				best->minIndex = minIndex;
+				best->maxIndex = maxIndex;
+				found = true;
+			}
+		}
+	}
+
+	return found && best->score > 0.0f;
+}
+
+/**
+ * Looks for index lists within the given data, returning the best candidates
+ * with the highest scoring first. If the number of vertices is known, any
+ * index at or above it rules a run out. If it's only a guess, given as
+ * numExpectedVertices, runs indexing past it just score lower.
+ */
+static std::vector<IndexCandidate> ScanForIndices(const uint8_t* data, size_t size, size_t minFaces, size_t numVertices,
+                                                  size_t numExpectedVertices) {
+	if (minFaces < 2) {
+		minFaces = 2;
+	}
+
+	size_t numRegions = (size + SCAN_REGION_SIZE - 1) / SCAN_REGION_SIZE;
+	std::vector<std::vector<IndexCandidate>> regionCandidates(numRegions);
+	GetThreadPool().ParallelFor(numRegions, [&](size_t region) {
+		size_t regionStart = region * SCAN_REGION_SIZE;
+		size_t regionEnd = std::min(size, regionStart + SCAN_REGION_SIZE);
+		size_t classifiedEnd = std::min(size, regionEnd + SCAN_MAX_PITCH);
+		std::vector<uint8_t> valid;
+
+		for (Job::FaceType type : { Job::FaceType::I16, Job::FaceType::I32 }) {
+			size_t indexSize = type == Job::FaceType::I16 ? 2 : 4;
+			// Without a vertex count, assume anything past 16 million isn't an index.
+			uint32_t bound = numVertices > 0 ? (uint32_t)std::min<size_t>(numVertices, UINT32_MAX) : (1u << 24);
+			if (type == Job::FaceType::I16) {
+				bound = std::min<uint32_t>(bound, 0xFFFF);
+			}
+			valid.resize((classifiedEnd - regionStart) / indexSize);
+			ClassifyIndices(data + regionStart, valid.size(), type, bound, valid.data());
+
+			auto IsValid = [&](size_t pos) {
+				size_t index = (pos - regionStart) / indexSize;
+				if (index < valid.size()) {
+					return valid[index] != 0;
+				}
+				uint8_t result;
+				ClassifyIndices(data + pos, 1, type, bound, &result);
+				return result != 0;
+			};
+			auto ReadIndex = [&](size_t pos) -> uint32_t {
+				if (type == Job::FaceType::I16) {
+					uint16_t v;
+					memcpy(&v, data + pos, sizeof(v));
+					return v;
+				}
+				uint32_t v;
+				memcpy(&v, data + pos, sizeof(v));
+				return v;
+			};
+			// Meshes are usually ordered well enough that neighbouring indices stay
+			// fairly close. Even degenerate faces don't repeat an index more than a
+			// few times in a row though, whereas zero-filled spans would otherwise
+			// read as one long run.
+			static constexpr size_t MAX_REPEATS = 4;
+			uint32_t window = std::max<uint32_t>(256, bound / 16);
+			auto IsCoherent = [&](size_t a, size_t b) {
+				uint32_t va = ReadIndex(a);
+				uint32_t vb = ReadIndex(b);
+				if (va == vb && a >= MAX_REPEATS * indexSize) {
+					size_t numRepeats = 1;
+					while (numRepeats <= MAX_REPEATS && ReadIndex(a - numRepeats * indexSize) == va) {
+						numRepeats++;
+					}
+					return numRepeats <= MAX_REPEATS;
+				}
+				return (va > vb ? va - vb : vb - va) <= window;
+			};
+			WalkRuns(regionStart, regionEnd, size, indexSize, indexSize, indexSize, minFaces * 3, IsValid, IsCoherent,
+			         [&](size_t start, size_t length) {
+				         IndexCandidate candidate;
+				         if (ScoreIndexCandidate(data, start, length, type, &candidate)) {
+					         if (numExpectedVertices > 0 && candidate.maxIndex >= numExpectedVertices) {
+						         candidate.score *= (float)std::sqrt((double)numExpectedVertices / ((double)candidate.maxIndex + 1.0));
+					         }
+					         regionCandidates[region].push_back(candidate);
+				         }
+			         });
+		}
+	});
+
+	std::vector<IndexCandidate> candidates;
+	for (const auto& region : regionCandidates) {
+		candidates.insert(candidates.end(), region.begin(), region.end());
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const IndexCandidate& a, const IndexCandidate& b) {
+		return a.score > b.score;
+	});
+
+	// Reading 32-bit indices as pairs of 16-bit ones tends to look valid too.
+	std::vector<IndexCandidate> best;
+	for (const auto& candidate : candidates) {
+		size_t indexSize = candidate.type == Job::FaceType::I16 ? 2 : 4;
+		size_t end = candidate.offset + candidate.numFaces * (candidate.quad ? 4 : 3) * indexSize;
+		bool overlaps = false;
+		for (const auto& other : best) {
+			size_t otherIndexSize = other.type == Job::FaceType::I16 ? 2 : 4;
+			size_t otherEnd = other.offset + other.numFaces * (other.quad ? 4 : 3) * otherIndexSize;
+			if (std::min(end, otherEnd) > std::max(candidate.offset, other.offset)) {
+				overlaps = true;
+				break;
+			}
+		}
+		if (!overlaps) {
+			best.push_back(candidate);
+		}
+	}
+
+	return best;
+}
+
+/**
+ * Scans the job's range instead of extracting it, printing out what was found.
+ */
+static bool RunScanJob(Job* job, InputFile* input) {
+	InputView view;
+	if (!OpenInputView(input, job->startOffset, job->endOffset > job->startOffset ? job->endOffset - job->startOffset : 0, &view)) {
+		Print("Failed to read from %" PRIu64 "!\n", job->startOffset);
+		return false;
+	}
+
+	static constexpr size_t MAX_REPORTED = 20;
+	// The best scanned vertex array may well not be the right one, so its
+	// count is only used as a hint for the faces, unlike an explicit -scvc.
+	size_t numExpectedVertices = 0;
+	if (job->scanVertices) {
+		Print("Scanning %zu bytes for vertices...\n", view.size);
+		std::vector<VertexCandidate> candidates = ScanForVertices(view.data, view.size, job->scanMinCount, job->scanBound);
+		if (!candidates.empty()) {
+			numExpectedVertices = candidates[0].count;
+		}
+		Print("Found %zu candidate vertex arrays\n", candidates.size());
+		for (size_t i = 0; i < std::min(candidates.size(), MAX_REPORTED); ++i) {
+			const VertexCandidate& c = candidates[i];
+			size_t elementSize = c.type == Job::VertexType::I16 ? 6 : 12;
+			uint64_t start = job->startOffset + c.offset;
+			uint64_t end = start + (c.count - 1) * c.pitch + elementSize;
+			Print("  %2zu: -soff %" PRIu64 " -eoff %" PRIu64 " -stri %zu -vtyp %d\n"
+			      "      %zu vertices, score %.1f, bounds (%g %g %g) to (%g %g %g)\n",
+			      i + 1, start, end, c.pitch - elementSize, (int)c.type, c.count, c.score,
+			      c.mins.x, c.mins.y, c.mins.z, c.maxs.x, c.maxs.y, c.maxs.z);
+			for (unsigned int j = 0; j < c.numAlternatives; ++j) {
+				const VertexReading& a = c.alternatives[j];
+				size_t alternativeSize = a.type == Job::VertexType::I16 ? 6 : 12;
+				uint64_t alternativeStart = job->startOffset + a.offset;
+				Print("      or -soff %" PRIu64 " -eoff %" PRIu64 " -stri %zu -vtyp %d, %zu vertices\n",
+				      alternativeStart, alternativeStart + (a.count - 1) * a.pitch + alternativeSize, a.pitch - alternativeSize,
+				      (int)a.type, a.count);
+			}
+		}
+	}
+
+	if (job->scanFaces) {
+		size_t numVertices = job->scanVertexCount;
+		if (numVertices > 0) {
+			Print("Scanning %zu bytes for faces, indexing up to %zu vertices...\n", view.size, numVertices);
+		} else if (numExpectedVertices > 0) {
+			Print("Scanning %zu bytes for faces, preferring those indexing up to %zu vertices...\n", view.size, numExpectedVertices);
+		} else {
+			Print("Scanning %zu bytes for faces...\n", view.size);
+		}
+		std::vector<IndexCandidate> candidates = ScanForIndices(view.data, view.size, job->scanMinCount, numVertices,
+		                                                        numVertices > 0 ? 0 : numExpectedVertices);
+		Print("Found %zu candidate face lists\n", candidates.size());
+		for (size_t i = 0; i < std::min(candidates.size(), MAX_REPORTED); ++i) {
+			const IndexCandidate& c = candidates[i];
+			size_t indexSize = c.type == Job::FaceType::I16 ? 2 : 4;
+			uint64_t start = job->startOffset + c.offset;
+			uint64_t end = start + c.numFaces * (c.quad ? 4 : 3) * indexSize;
+			Print("  %2zu: -fsof %" PRIu64 " -feof %" PRIu64 " -ftyp %d%s\n"
+			      "      %zu faces, score %.1f, indices %u to %u, %.1f%% degenerate\n",
+			      i + 1, start, end, (int)c.type, c.quad ? " -fquad" : "", c.numFaces, c.score,
+			      c.minIndex, c.maxIndex, c.degenerate * 100.0f);
+		}
+	}
+
+	CloseInputView(&view);
+	return true;
+}
+
+static size_t GetVertexSize(const Job* job) {
+	if (job->vertexLayoutSize > 0) {
+		return job->vertexLayoutSize;
+	}
+	switch( job->vertexType ) {
+		default:
+			return sizeof( Vertex );
+		case Job::VertexType::I16:
+		case Job::VertexType::F16:
+		case Job::VertexType::UNORM16:
+		case Job::VertexType::SNORM16:
+			return sizeof( int16_t ) * 3;
+		case Job::VertexType::UNORM8:
+		case Job::VertexType::SNORM8:
+			return sizeof( int8_t ) * 3;
+		case Job::VertexType::FX32:
+			return sizeof( int32_t ) * 3;
+		case Job::VertexType::UNORM10_10_10_2:
+		case Job::VertexType::SNORM10_10_10_2:
+		case Job::VertexType::F11_11_10:
+			return sizeof( uint32_t );
+	}
+}
+
+/**
+ * Returns scale with the fixed-point fraction folded in, falling back to
+ * defaultFractionalBits if fractionalBits isn't set.
+ */
+static float GetFixedPointScale(float scale, int fractionalBits, int defaultFractionalBits) {
+	return std::ldexp(scale, -(fractionalBits >= 0 ? fractionalBits : defaultFractionalBits));
+}
+
+template<bool Swap, size_t Pitch, typename Output>
+static void DecodeVerticesAs(Job::VertexType type, float scale, int fractionalBits, const uint8_t* src, size_t count,
+                             size_t pitch, Output* out) {
+	switch( type ) {
+		default:
+			DecodeVerticesF32<Swap, Pitch>(src, count, pitch, scale, out);
+			break;
+		case Job::VertexType::I16:
+			DecodeVerticesInt<int16_t, Swap, Pitch>(src, count, pitch, GetFixedPointScale(scale, fractionalBits, 0), -FLT_MAX, out);
+			break;
+		case Job::VertexType::F16:
+			DecodeVerticesF16<Swap, Pitch>(src, count, pitch, scale, out);
+			break;
+		case Job::VertexType::UNORM8:
+			DecodeVerticesInt<uint8_t, Swap, Pitch>(src, count, pitch, scale / 255.0f, -FLT_MAX, out);
+			break;
+		case Job::VertexType::SNORM8:
+			DecodeVerticesInt<int8_t, Swap, Pitch>(src, count, pitch, scale / 127.0f, -127.0f, out);
+			break;
+		case Job::VertexType::UNORM16:
+			DecodeVerticesInt<uint16_t, Swap, Pitch>(src, count, pitch, scale / 65535.0f, -FLT_MAX, out);
+			break;
+		case Job::VertexType::SNORM16:
+			DecodeVerticesInt<int16_t, Swap, Pitch>(src, count, pitch, scale / 32767.0f, -32767.0f, out);
+			break;
+		case Job::VertexType::FX32:
+			DecodeVerticesInt<int32_t, Swap, Pitch>(src, count, pitch, GetFixedPointScale(scale, fractionalBits, 16), -FLT_MAX, out);
+			break;
+		case Job::VertexType::UNORM10_10_10_2:
+			DecodeVertices10_10_10_2<false, Swap, Pitch>(src, count, pitch, scale, out);
+			break;
+		case Job::VertexType::SNORM10_10_10_2:
+			DecodeVertices10_10_10_2<true, Swap, Pitch>(src, count, pitch, scale, out);
+			break;
+		case Job::VertexType::F11_11_10:
+			DecodeVertices11_11_10<Swap, Pitch>(src, count, pitch, scale, out);
+			break;
+	}
+}
+
+/**
+ * Decodes count vertices into out, which is either Vertex or VertexArrays,
+ * using the kernel for the given type, byte order and pitch.
+ */
+template<typename Output>
+static void DecodeVertices(Job::VertexType type, float scale, int fractionalBits, bool bigEndian, const uint8_t* src,
+                           size_t count, size_t pitch, Output* out) {
+	bool swap = bigEndian != IsBigEndianHost();
+	DispatchPitch(pitch, [&](auto constantPitch) {
+		constexpr size_t PITCH = decltype(constantPitch)::value;
+		if (swap) {
+			DecodeVerticesAs<true, PITCH>(type, scale, fractionalBits, src, count, pitch, out);
+		} else {
+			DecodeVerticesAs<false, PITCH>(type, scale, fractionalBits, src, count, pitch, out);
+		}
+	});
+}
+
+template<typename Output>
+static void DecodeVertices(const Job* job, const uint8_t* src, size_t count, size_t pitch, Output* out) {
+	DecodeVertices(job->vertexType, job->scale, job->vertexFractionalBits, job->vertexBigEndian, src, count, pitch, out);
+}
+
+/**
+ * Decodes count texture coordinates, spaced pitch bytes apart, using load to
+ * read each component.
+ */
+template<size_t Pitch, typename Load>
+static void DecodeTexCoordsWith(const uint8_t* src, size_t count, size_t runtimePitch, size_t componentSize, const Load& load,
+                                TexCoord* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	for (size_t i = 0; i < count; ++i) {
+		const uint8_t* p = src + i * pitch;
+		out[i].u = load(p);
+		out[i].v = load(p + componentSize);
+	}
+}
+
+template<bool Swap, size_t Pitch>
+static void DecodeTexCoordsAs(Job::VertexType type, const uint8_t* src, size_t count, size_t pitch, TexCoord* out) {
+	switch( type ) {
+		default:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(float), [](const uint8_t* p) {
+				return LoadScalar<float, Swap>(p);
+			}, out);
+			break;
+		case Job::VertexType::I16:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(int16_t), [](const uint8_t* p) {
+				return (float)LoadScalar<int16_t, Swap>(p);
+			}, out);
+			break;
+		case Job::VertexType::F16:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(uint16_t), [](const uint8_t* p) {
+				return HalfToFloat(LoadScalar<uint16_t, Swap>(p));
+			}, out);
+			break;
+		case Job::VertexType::UNORM8:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(uint8_t), [](const uint8_t* p) {
+				return LoadScalar<uint8_t, Swap>(p) / 255.0f;
+			}, out);
+			break;
+		case Job::VertexType::SNORM8:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(int8_t), [](const uint8_t* p) {
+				return std::max(LoadScalar<int8_t, Swap>(p) / 127.0f, -1.0f);
+			}, out);
+			break;
+		case Job::VertexType::UNORM16:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(uint16_t), [](const uint8_t* p) {
+				return LoadScalar<uint16_t, Swap>(p) / 65535.0f;
+			}, out);
+			break;
+		case Job::VertexType::SNORM16:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(int16_t), [](const uint8_t* p) {
+				return std::max(LoadScalar<int16_t, Swap>(p) / 32767.0f, -1.0f);
+			}, out);
+			break;
+		case Job::VertexType::FX32:
+			DecodeTexCoordsWith<Pitch>(src, count, pitch, sizeof(int32_t), [](const uint8_t* p) {
+				return LoadScalar<int32_t, Swap>(p) / 65536.0f;
+			}, out);
+			break;
+	}
+}
+
+static void DecodeTexCoords(Job::VertexType type, bool bigEndian, const uint8_t* src, size_t count, size_t pitch, TexCoord* out) {
+	bool swap = bigEndian != IsBigEndianHost();
+	DispatchPitch(pitch, [&](auto constantPitch) {
+		constexpr size_t PITCH = decltype(constantPitch)::value;
+		if (swap) {
+			DecodeTexCoordsAs<true, PITCH>(type, src, count, pitch, out);
+		} else {
+			DecodeTexCoordsAs<false, PITCH>(type, src, count, pitch, out);
+		}
+	});
+}
+
+/**
+ * Decodes and sanitises count vertices into out. With -vsoa, that's done in
+ * the given arrays first, which are left holding the vertices afterwards.
+ */
+static void LoadVertices(const Job* job, const uint8_t* src, size_t count, size_t pitch, VertexArrays* arrays,
+                         Vertex* out, SanitizeReport* report) {
+	if (!job->soaVertices) {
+		DecodeVertices(job, src, count, pitch, out);
+		SanitizeVertices(out, count, job->flushNonFinite, report);
+		return;
+	}
+
+	arrays->Resize(count);
+	DecodeVertices(job, src, count, pitch, arrays);
+	SanitizeVertices(arrays, job->flushNonFinite, report);
+	StoreVertexArrays(*arrays, out);
+}
+
+/**
+ * Sizes the job's vertices, along with any normals and texture coordinates.
+ */
+static void ResizeAttributes(Job* job, size_t count) {
+	job->meshVertices.resize(count);
+	if (job->vertexNormal.present) {
+		job->meshNormals.resize(count);
+	}
+	if (job->vertexTexCoord.present) {
+		job->meshTexCoords.resize(count);
+	}
+}
+
+/**
+ * Loads and sanitises count vertices from src into the job, along with any
+ * normals and texture coordinates. Those are decoded a block at a time
+ * alongside the positions, so the interleaved data is only swept through once.
+ */
+static void LoadAttributes(Job* job, const uint8_t* src, size_t count, size_t pitch, VertexArrays* arrays, SanitizeReport* report) {
+	if (!job->vertexNormal.present && !job->vertexTexCoord.present) {
+		LoadVertices(job, src + job->vertexPositionOffset, count, pitch, arrays, job->meshVertices.data(), report);
+		return;
+	}
+
+	static constexpr size_t BLOCK_SIZE = 1024;
+	size_t firstVertex = report->firstVertex;
+	for (size_t first = 0; first < count; first += BLOCK_SIZE) {
+		size_t blockCount = std::min(BLOCK_SIZE, count - first);
+		const uint8_t* block = src + first * pitch;
+		report->firstVertex = firstVertex + first;
+		LoadVertices(job, block + job->vertexPositionOffset, blockCount, pitch, arrays, &job->meshVertices[first], report);
+		if (job->vertexNormal.present) {
+			DecodeVertices(job->vertexNormal.type, 1.0f, -1, job->vertexBigEndian, block + job->vertexNormal.offset, blockCount,
+			               pitch, &job->meshNormals[first]);
+			SanitizeVertices(&job->meshNormals[first], blockCount, job->flushNonFinite, report);
+		}
+		if (job->vertexTexCoord.present) {
+			DecodeTexCoords(job->vertexTexCoord.type, job->vertexBigEndian, block + job->vertexTexCoord.offset, blockCount,
+			                pitch, &job->meshTexCoords[first]);
+			SanitizeTexCoords(&job->meshTexCoords[first], blockCount, job->flushNonFinite, report);
+		}
+	}
+	report->firstVertex = firstVertex;
+}
+
+static unsigned int GetFaceIndexSize(const Job* job) {
+	switch( job->faceType ) {
+		default:
+			return sizeof( uint32_t );
+		case Job::FaceType::I16:
+			return sizeof( uint16_t );
+	}
+}
+
+template<bool Swap, size_t Pitch>
+static void DecodeFacesAs(const Job* job, const uint8_t* src, size_t count, size_t pitch, Face* out) {
+	switch( job->faceType ) {
+		default:
+			if (job->faceQuad) {
+				WidenFaces<uint32_t, 4, Swap, Pitch>(src, count, pitch, out);
+			} else {
+				WidenFaces<uint32_t, 3, Swap, Pitch>(src, count, pitch, out);
+			}
+			break;
+		case Job::FaceType::I16:
+			if (job->faceQuad) {
+				WidenFaces<uint16_t, 4, Swap, Pitch>(src, count, pitch, out);
+			} else {
+				WidenFaces<uint16_t, 3, Swap, Pitch>(src, count, pitch, out);
+			}
+			break;
+	}
+}
+
+static void DecodeFaces(const Job* job, const uint8_t* src, size_t count, size_t pitch, Face* out) {
+	bool swap = job->faceBigEndian != IsBigEndianHost();
+	DispatchPitch(pitch, [&](auto constantPitch) {
+		constexpr size_t PITCH = decltype(constantPitch)::value;
+		if (swap) {
+			DecodeFacesAs<true, PITCH>(job, src, count, pitch, out);
+		} else {
+			DecodeFacesAs<false, PITCH>(job, src, count, pitch, out);
+		}
+	});
+}
+
+/**
+ * Size of each face read in, or of each index for strips and fans.
+ */
+static size_t GetFaceElementSize(const Job* job) {
+	if (job->faceTopology != Job::FaceTopology::LIST) {
+		return GetFaceIndexSize(job);
+	}
+	return GetFaceIndexSize(job) * (job->faceQuad ? 4 : 3);
+}
+
+/**
+ * Widens count indices, spaced pitch bytes apart, into out.
+ */
+template<typename Index, bool Swap = false, size_t Pitch = 0>
+static void WidenIndices(const uint8_t* src, size_t count, size_t runtimePitch, uint32_t* out) {
+	const size_t pitch = Pitch != 0 ? Pitch : runtimePitch;
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = LoadScalar<Index, Swap>(src + i * pitch);
+	}
+}
+
+static void DecodeIndices(const Job* job, const uint8_t* src, size_t count, size_t pitch, uint32_t* out) {
+	bool swap = job->faceBigEndian != IsBigEndianHost();
+	DispatchPitch(pitch, [&](auto constantPitch) {
+		constexpr size_t PITCH = decltype(constantPitch)::value;
+		if (job->faceType == Job::FaceType::I16) {
+			if (swap) {
+				WidenIndices<uint16_t, true, PITCH>(src, count, pitch, out);
+			} else {
+				WidenIndices<uint16_t, false, PITCH>(src, count, pitch, out);
+			}
+		} else if (swap) {
+			WidenIndices<uint32_t, true, PITCH>(src, count, pitch, out);
+		} else {
+			WidenIndices<uint32_t, false, PITCH>(src, count, pitch, out);
+		}
+	});
+}
+
+/**
+ * Where a strip or fan got up to, so one split across several reads carries
+ * on where the last left off.
+ */
+struct StripState {
+	uint32_t first{ 0 };
+	uint32_t previous[2]{ 0, 0 };
+	size_t length{ 0 }; // Indices since the last restart.
+};
+
+/**
+ * Turns count strip or fan indices into triangles in a single pass, returning
+ * how many were written to out, which needs room for count of them. Every
+ * other strip triangle has its first two indices swapped, so they all wind the
+ * same way. An index equal to restart begins a new strip or fan, and one with
+ * adcMask set skips the triangle it completes, though it still moves things
+ * along.
+ */
+template<bool Fan>
+static size_t AssembleTriangles(const uint32_t* indices, size_t count, uint64_t restart, uint32_t adcMask, StripState* state, Face* out) {
+	size_t numTriangles = 0;
+	for (size_t i = 0; i < count; ++i) {
+		uint32_t index = indices[i];
+		if (index == restart) {
+			state->length = 0;
+			continue;
+		}
+
+		bool skip = (index & adcMask) != 0;
+		index &= ~adcMask;
+		if (state->length >= 2 && !skip) {
+			Face* face = &out[numTriangles++];
+			if constexpr (Fan) {
+				face->x = state->first;
+				face->y = state->previous[1];
+			} else {
+				bool odd = (state->length & 1) != 0;
+				face->x = state->previous[odd ? 1 : 0];
+				face->y = state->previous[odd ? 0 : 1];
+			}
+			face->z = index;
+			face->w = 0;
+		}
+
+		if (state->length == 0) {
+			state->first = index;
+		}
+		state->previous[0] = state->previous[1];
+		state->previous[1] = index;
+		state->length++;
+	}
+	return numTriangles;
+}
+
+/**
+ * Assembles the strips or fans in indices into the triangles in faces. A
+ * restart leaves nothing to carry over, so if they're enabled the indices are
+ * split at them into chunks which are assembled in parallel.
+ */
+static void AssembleFaces(const Job* job, const std::vector<uint32_t>& indices, StripState* state, std::vector<Face>* faces) {
+	static constexpr size_t CHUNK_SIZE = 65536;
+	bool shortIndices = job->faceType == Job::FaceType::I16;
+	uint64_t restart = !job->faceRestart ? UINT64_MAX : shortIndices ? 0xFFFF : 0xFFFFFFFF;
+	uint32_t adcMask = !job->faceAdcFlags ? 0 : shortIndices ? 0x8000 : 0x80000000;
+
+	// Each chunk past the first starts on a restart.
+	std::vector<size_t> starts{ 0 };
+	if (job->faceRestart) {
+		for (size_t i = CHUNK_SIZE; i < indices.size(); i = starts.back() + CHUNK_SIZE) {
+			auto r = std::find(indices.begin() + i, indices.end(), (uint32_t)restart);
+			if (r == indices.end()) {
+				break;
+			}
+			starts.push_back(r - indices.begin());
+		}
+	}
+	starts.push_back(indices.size());
+
+	size_t numChunks = starts.size() - 1;
+	std::vector<StripState> states(numChunks);
+	std::vector<size_t> counts(numChunks);
+	states[0] = *state;
+	faces->resize(indices.size());
+	Face* out = faces->data();
+	GetThreadPool().ParallelFor(numChunks, [&](size_t i) {
+		const uint32_t* src = indices.data() + starts[i];
+		size_t count = starts[i + 1] - starts[i];
+		if (job->faceTopology == Job::FaceTopology::FAN) {
+			counts[i] = AssembleTriangles<true>(src, count, restart, adcMask, &states[i], out + starts[i]);
+		} else {
+			counts[i] = AssembleTriangles<false>(src, count, restart, adcMask, &states[i], out + starts[i]);
+		}
+	});
+	*state = states.back();
+
+	// Each chunk wrote from where its indices start, so close up the gaps.
+	size_t numTriangles = counts[0];
+	for (size_t i = 1; i < numChunks; ++i) {
+		std::copy(out + starts[i], out + starts[i] + counts[i], out + numTriangles);
+		numTriangles += counts[i];
+	}
+	faces->resize(numTriangles);
+}
+
+/**
+ * Decodes count faces, or count indices for strips and fans, from src into
+ * the job's faces.
+ */
+static void LoadFaces(Job* job, const uint8_t* src, size_t count, size_t pitch, StripState* state) {
+	if (job->faceTopology == Job::FaceTopology::LIST) {
+		job->meshFaces.resize(count);
+		DecodeFaces(job, src, count, pitch, job->meshFaces.data());
+		return;
+	}
+
+	std::vector<uint32_t> indices(count);
+	DecodeIndices(job, src, count, pitch, indices.data());
+	AssembleFaces(job, indices, state, &job->meshFaces);
+}
+
+/**
+ * Works out how many elements, spaced pitch bytes apart, fit between the given
+ * offsets. If the end isn't past the start, it's taken as the end of the file.
+ */
+static size_t CountElements(const InputFile* input, uint64_t start, uint64_t end, size_t elementSize, size_t pitch) {
+	if (end <= start || end > input->size) {
+		end = input->size;
+	}
+	if (start >= end || end - start < elementSize) {
+		return 0;
+	}
+
+	return (size_t)((end - start - elementSize) / pitch + 1);
+}
+
+static inline uint64_t GetElementBytes(size_t count, size_t elementSize, size_t pitch) {
+	return count > 0 ? (uint64_t)(count - 1) * pitch + elementSize : 0;
+}
+
+static void PrintSanitizeReport(const Job* job, const SanitizeReport& report, size_t vertexPitch) {
+	if (report.numOffenders == 0) {
+		return;
+	}
+
+	Warn("Encountered %zu NaN, %zu infinite and %zu denormal vertex components - defaulting to 0.0!\n",
+	     report.numNaN, report.numInfinite, report.numDenormal);
+	size_t offenders[SanitizeReport::MAX_OFFENDERS];
+	std::copy(report.offenders, report.offenders + report.numOffenders, offenders);
+	std::sort(offenders, offenders + report.numOffenders);
+	Print("First offending vertices at offsets:");
+	for (unsigned int i = 0; i < report.numOffenders; ++i) {
+		Print(" %" PRIu64, job->startOffset + (uint64_t)offenders[i] * vertexPitch);
+	}
+	Print("\n");
+}
+
+static void PrintFaceBoundsReport(const Job* job, const FaceBoundsReport& report) {
+	if (report.numFaces == 0) {
+		return;
+	}
+
+	Warn("Encountered %zu out of bound vertex indices across %zu faces, largest was %u - %s!\n",
+	     report.numIndices, report.numFaces, report.largestIndex,
+	     job->dropOutOfBounds ? "dropping those faces" : "defaulting to 0");
+}
+
+static void PrintVertices(const Vertex* vertices, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		Print( "\tx( %f ) y( %f ) z( %f )\n", vertices[i].x, vertices[i].y, vertices[i].z );
+	}
+}
+
+static void PrintFaces(const Face* faces, size_t count, bool quad) {
+	for (size_t i = 0; i < count; ++i) {
+		const Face& f = faces[i];
+		if (quad) {
+			Print("\tx( %u ) y( %u ) z( %u ) w( %u )\n", f.x, f.y, f.z, f.w);
+		} else {
+			Print("\tx( %u ) y( %u ) z( %u )\n", f.x, f.y, f.z);
+		}
+	}
+}
+
+static void ResolveOutputFormat(Job* job) {
+	if (job->outputFormat != Job::OutputFormat::AUTO) {
+		return;
+	}
+
+	const char* extension = strrchr(job->outPath.c_str(), '.');
+	if (extension != nullptr && (strcmp(extension, ".ply") == 0 || strcmp(extension, ".PLY") == 0)) {
+		job->outputFormat = Job::OutputFormat::PLY;
+	} else if (extension != nullptr && (strcmp(extension, ".glb") == 0 || strcmp(extension, ".GLB") == 0)) {
+		job->outputFormat = Job::OutputFormat::GLB;
+	} else {
+		job->outputFormat = Job::OutputFormat::OBJ;
+	}
+}
+
+/**
+ * Converts the job straight through to an obj, a window at a time, so that
+ * no more than streamWindow vertices or faces are ever held at once. The
+ * vertex count is known from the offsets up front, so faces can still be
+ * checked against it without the vertices sticking around.
+ */
+static bool StreamJob(Job* job, InputFile* input) {
+	size_t vertexSize = GetVertexSize(job);
+	size_t vertexPitch = vertexSize + (size_t)job->stride;
+	if (job->startOffset >= input->size) {
+		Print("Failed to read from %" PRIu64 "!\n", job->startOffset);
+		return false;
+	}
+	size_t numVertices = CountElements(input, job->startOffset, job->endOffset, vertexSize, vertexPitch);
+
+	FILE* file = fopen(job->outPath.c_str(), "w");
+	if (file == nullptr) {
+		Print("Failed to write \"%s\"!\n", job->outPath.c_str());
+		return false;
+	}
+
+	fprintf(file, "# Generated by Bin2Obj, by Mark \"hogsy\" Sowden <hogsy@oldtimes-software.com>\n\n");
+	if (job->precision > MAX_PRECISION) {
+		job->precision = MAX_PRECISION;
+	}
+
+	bool streamed = true;
+	size_t window = job->streamWindow;
+	SanitizeReport report;
+	VertexArrays arrays;
+	ResizeAttributes(job, std::min(numVertices, window));
+	for (size_t first = 0; first < numVertices; first += window) {
+		size_t count = std::min(window, numVertices - first);
+		uint64_t offset = job->startOffset + (uint64_t)first * vertexPitch;
+		InputView view;
+		uint64_t numBytes = GetElementBytes(count, vertexSize, vertexPitch);
+		if (!OpenInputView(input, offset, numBytes, &view) || view.size < numBytes) {
+			CloseInputView(&view);
+			Print("Failed to read from %" PRIu64 "!\n", offset);
+			streamed = false;
+			break;
+		}
+		report.firstVertex = first;
+		LoadAttributes(job, view.data, count, vertexPitch, &arrays, &report);
+		CloseInputView(&view);
+		if (env.verbose) {
+			PrintVertices(job->meshVertices.data(), count);
+		}
+
+		WriteChunked(file, count, [job](size_t start, size_t count, std::vector<char>* out) {
+			FormatVertices(job->meshVertices.data() + start, count, job->precision, "v", out);
+		});
+		WriteAttributes(file, job, 0, count);
+	}
+	job->meshVertices = std::vector<Vertex>();
+	job->meshNormals = std::vector<Vertex>();
+	job->meshTexCoords = std::vector<TexCoord>();
+	PrintSanitizeReport(job, report, vertexPitch);
+	Print( "Streamed %d vertices\n", (int)numVertices );
+
+	if (streamed && job->faceEndOffset > job->faceStartOffset) {
+		unsigned int numFaceElements = job->faceQuad ? 4 : 3;
+		size_t faceSize = GetFaceElementSize(job);
+		size_t facePitch = faceSize + (size_t)job->faceStride;
+		size_t numFaces = CountElements(input, job->faceStartOffset, job->faceEndOffset, faceSize, facePitch);
+
+		StripState strip;
+		FaceBoundsReport boundsReport;
+		size_t numWritten = 0;
+		size_t numDegenerate = 0;
+		for (size_t first = 0; first < numFaces; first += window) {
+			size_t count = std::min(window, numFaces - first);
+			uint64_t offset = job->faceStartOffset + (uint64_t)first * facePitch;
+			InputView view;
+			uint64_t numBytes = GetElementBytes(count, faceSize, facePitch);
+			if (!OpenInputView(input, offset, numBytes, &view) || view.size < numBytes) {
+				CloseInputView(&view);
+				Print("Failed to read faces from %" PRIu64 "!\n", offset);
+				streamed = false;
+				break;
+			}
+			LoadFaces(job, view.data, count, facePitch, &strip);
+			CloseInputView(&view);
+
+			if (env.verbose) {
+				PrintFaces(job->meshFaces.data(), job->meshFaces.size(), job->faceQuad);
+			}
+
+			ValidateFaceIndices(&job->meshFaces, numFaceElements, numVertices, job->dropOutOfBounds, &boundsReport);
+			numDegenerate += FilterDegenerateFaces(&job->meshFaces, numFaceElements);
+			numWritten += job->meshFaces.size();
+
+			WriteChunked(file, job->meshFaces.size(), [job, numFaceElements](size_t start, size_t count, std::vector<char>* out) {
+				FormatFaces(job->meshFaces.data() + start, count, numFaceElements, job->vertexTexCoord.present,
+				            job->vertexNormal.present, out);
+			});
+		}
+		job->meshFaces = std::vector<Face>();
+		PrintFaceBoundsReport(job, boundsReport);
+		if (numDegenerate > 0) {
+			Print("Dropped %zu degenerate faces\n", numDegenerate);
+		}
+		Print( "Streamed %d faces\n", (int)numWritten );
+	}
+
+	if (!FinishFile(file)) {
+		Print("Failed to write \"%s\"!\n", job->outPath.c_str());
+		streamed = false;
+	}
+
+	return streamed;
+}
+
+/**
+ * Loads in the mesh described by the job and writes it out.
+ */
+static bool RunJob(Job* job) {
+	Print("Loading \"%s\"\n", job->filePath.c_str());
+
+	InputFile* input = AcquireInputFile(job->filePath);
+	if (input == nullptr) {
+		Print("Failed to open \"%s\"!\n", job->filePath.c_str());
+		ReleaseInputFile(job->filePath);
+		return false;
+	}
+
+	if (job->scanVertices || job->scanFaces) {
+		bool scanned = RunScanJob(job, input);
+		ReleaseInputFile(job->filePath);
+		return scanned;
+	}
+
+	ResolveOutputFormat(job);
+	if (job->faceQuad && job->faceTopology != Job::FaceTopology::LIST) {
+		Warn("Strips and fans are always turned into triangles, ignoring -fquad!\n");
+		job->faceQuad = false;
+	}
+	if (job->vertexNormal.present || job->vertexTexCoord.present) {
+		if (job->outputFormat != Job::OutputFormat::OBJ) {
+			Warn("Normals and texture coordinates are only written to obj, dropping them!\n");
+			job->vertexNormal.present = false;
+			job->vertexTexCoord.present = false;
+		} else if (job->weld) {
+			Warn("Welding would leave the normals and texture coordinates behind, skipping it!\n");
+			job->weld = false;
+		}
+	}
+	if (job->streamWindow > 0) {
+		if (job->outputFormat != Job::OutputFormat::OBJ) {
+			Warn("Streaming is only supported for obj output, loading the whole mesh instead!\n");
+		} else if (job->weld) {
+			Warn("Welding needs the whole mesh, loading it all in instead of streaming!\n");
+		} else {
+			bool streamed = StreamJob(job, input);
+			ReleaseInputFile(job->filePath);
+			if (streamed) {
+				Print("Wrote \"%s\"!\n", job->outPath.c_str());
+			}
+			return streamed;
+		}
+	}
+
+	// Work out exactly how much we're loading up front, so everything is decoded straight into place.
+	size_t vertexSize = GetVertexSize(job);
+	size_t vertexPitch = vertexSize + (size_t)job->stride;
+	size_t numVertices = CountElements(input, job->startOffset, job->endOffset, vertexSize, vertexPitch);
+	uint64_t vertexBytes = GetElementBytes(numVertices, vertexSize, vertexPitch);
+
+	InputView view;
+	if (!OpenInputView(input, job->startOffset, vertexBytes, &view) || view.size < vertexBytes) {
+		CloseInputView(&view);
+		ReleaseInputFile(job->filePath);
+		Print("Failed to read from %" PRIu64 "!\n", job->startOffset);
+		return false;
+	}
+
+	ResizeAttributes(job, numVertices);
+	SanitizeReport report;
+	VertexArrays arrays;
+	LoadAttributes(job, view.data, numVertices, vertexPitch, &arrays, &report);
+	PrintSanitizeReport(job, report, vertexPitch);
+
+	// Welding can drop the vertices at the extremes, so these are only any use if that's not happening.
+	Vertex bounds[2];
+	const Vertex* knownBounds = nullptr;
+	if (job->soaVertices && job->outputFormat == Job::OutputFormat::GLB && !job->weld) {
+		ComputeBounds(arrays, &bounds[0], &bounds[1]);
+		knownBounds = bounds;
+	}
+	arrays = VertexArrays();
+
+	if (env.verbose) {
+		PrintVertices(job->meshVertices.data(), job->meshVertices.size());
+	}
+	Print( "Loaded in %d vertices\n", (int)job->meshVertices.size() );
+	// If both start and end offsets are defined for the faces, load those in.
+	if( job->faceEndOffset > job->faceStartOffset ) {
+		Print("Attempting to read in faces...\n");
+
+		unsigned int numFaceElements = job->faceQuad ? 4 : 3;
+		size_t faceSize = GetFaceElementSize(job);
+		size_t facePitch = faceSize + (size_t)job->faceStride;
+		size_t numFaces = CountElements(input, job->faceStartOffset, job->faceEndOffset, faceSize, facePitch);
+		uint64_t faceBytes = GetElementBytes(numFaces, faceSize, facePitch);
+
+		InputView faceView;
+		if (!OpenInputView(input, job->faceStartOffset, faceBytes, &faceView) || faceView.size < faceBytes) {
+			CloseInputView(&faceView);
+			CloseInputView(&view);
+			ReleaseInputFile(job->filePath);
+			Print("Failed to read faces from %" PRIu64 "!\n", job->faceStartOffset);
+			return false;
+		}
+
+		StripState strip;
+		LoadFaces(job, faceView.data, numFaces, facePitch, &strip);
+		CloseInputView(&faceView);
+
+		if (env.verbose) {
+			PrintFaces(job->meshFaces.data(), job->meshFaces.size(), job->faceQuad);
+		}
+
+		FaceBoundsReport boundsReport;
+		ValidateFaceIndices(&job->meshFaces, numFaceElements, job->meshVertices.size(), job->dropOutOfBounds, &boundsReport);
+		PrintFaceBoundsReport(job, boundsReport);
+		Print( "Loaded in %d faces\n", (int)job->meshFaces.size() );
+	}
+
+	if (job->weld) {
+		size_t numWelded = WeldVertices(&job->meshVertices, &job->meshFaces, job->faceQuad ? 4 : 3, job->weldTolerance);
+		Print("Welded %zu vertices, leaving %zu\n", numWelded, job->meshVertices.size());
+	}
+
+	size_t numDegenerate = FilterDegenerateFaces(&job->meshFaces, job->faceQuad ? 4 : 3);
+	if (numDegenerate > 0) {
+		Print("Dropped %zu degenerate faces\n", numDegenerate);
+	}
+
+	bool written;
+	switch (job->outputFormat) {
+		default:
+			written = WriteObj(job, job->outPath.c_str());
+			break;
+		case Job::OutputFormat::PLY:
+			written = WritePly(job, job->outPath.c_str());
+			break;
+		case Job::OutputFormat::GLB: {
+			// If the source is already little-endian float32 positions that we've left
+			// untouched, and the stride is something glTF can describe, just point at it.
+			bool canReference = job->vertexType == Job::VertexType::F32 && !job->vertexBigEndian && job->scale == 1.0f &&
+			                    report.numOffenders == 0 && !job->weld && vertexPitch % 4 == 0 && vertexPitch <= 252;
+			written = WriteGlb(job, job->outPath.c_str(), canReference ? view.data + job->vertexPositionOffset : nullptr, vertexPitch,
+			                   knownBounds);
+			break;
+		}
+	}
+	CloseInputView(&view);
+	ReleaseInputFile(job->filePath);
+
+	// Nothing else needs the mesh now, so give the memory back.
+	job->meshVertices = std::vector<Vertex>();
+	job->meshNormals = std::vector<Vertex>();
+	job->meshTexCoords = std::vector<TexCoord>();
+	job->meshFaces = std::vector<Face>();
+
+	if (!written) {
+		Print("Failed to write \"%s\"!\n", job->outPath.c_str());
+		return false;
+	}
+
+	Print("Wrote \"%s\"!\n", job->outPath.c_str());
+
+	return true;
+}
+
+int main(int argc, char** argv) {
+	Print(
+		"Bin2Obj by Mark \"hogsy\" Sowden <hogsy@oldtimes-software.com>\n"
+		"==============================================================\n\n"
+	);
+
+	ParseCommandLine(argc, argv);
+
+	// A single job gets the whole thread pool to itself, otherwise the jobs
+	// are spread across the pool and each runs serially.
+	for (const auto& job : env.jobs) {
+		sharedInputFiles[job.filePath].numJobs++;
+	}
+
+	std::vector<char> succeeded(env.jobs.size(), false);
+	if (env.jobs.size() == 1) {
+		succeeded[0] = RunJob(&env.jobs[0]);
+	} else {
+		Print("Running %zu jobs...\n", env.jobs.size());
+		GetThreadPool().ParallelFor(env.jobs.size(), [&succeeded](size_t i) {
+			// Jobs are numbered in the order they were given, from one.
+			std::string prefix = "[job " + std::to_string(i + 1) + "] ";
+			logPrefix = prefix.c_str();
+			logLineStart = true;
+			succeeded[i] = RunJob(&env.jobs[i]);
+			logPrefix = nullptr;
+		});
+	}
+
+	size_t numFailed = std::count(succeeded.begin(), succeeded.end(), false);
+	if (numFailed > 0) {
+		if (env.jobs.size() > 1) {
+			Print("%zu of %zu jobs failed!\n", numFailed, env.jobs.size());
+		}
+		return EXIT_FAILURE;
+	}
 
 	return EXIT_SUCCESS;
 }